@@ -1,6 +1,10 @@
 // Property of Lucian Tranc
 
 #include "NTTDataInterface.h"
+#include "NTTDiagnostics.h"
+#include "NTTLayoutCache.h"
+#include "NTTStats.h"
+#include "NTTVMKernels.h"
 #include "NiagaraCompileHashVisitor.h"
 #include "NiagaraSystemInstance.h"
 #include "NiagaraEmitterInstance.h"
@@ -10,6 +14,9 @@
 #include "NiagaraDataInterfaceUtilities.h"
 #include "RHI.h"
 #include "VectorVM.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Engine/World.h"
 
 DEFINE_LOG_CATEGORY(LogNiagaraTextToolkit);
 
@@ -17,89 +24,326 @@ DEFINE_LOG_CATEGORY(LogNiagaraTextToolkit);
 
 static const TCHAR* FontUVTemplateShaderFile = TEXT("/Plugin/NiagaraTextToolkit/Private/NTTDataInterface.ush");
 
-static bool IsWhitespaceChar(int32 Code)
+void FNTTNumericFormat::Append(FStringBuilderBase& Out, double Value) const
 {
-	return Code == ' '
-		|| Code == '\t';
-}
+	static constexpr uint64 PowersOfTen[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
 
-// Iterator that understands newlines and reports original source indices per character,
-struct FNTTTextIterator
-{
-	const FString& Source;
-	const int32 Length;
-	int32 CurrentIndex;
+	const int32 NumDecimals = FMath::Clamp(Decimals, 0, 9);
+	const uint64 Scale = PowersOfTen[NumDecimals];
 
-	explicit FNTTTextIterator(const FString& InSource)
-		: Source(InSource)
-		, Length(InSource.Len())
-		, CurrentIndex(0)
+	if (!FMath::IsFinite(Value))
 	{
+		Value = 0.0;
 	}
 
-	// Returns true as long as we are not past the end of the string.
-	bool HasNextCharacter()
+	// Work on the scaled magnitude as an integer so rounding happens once and digits come out exact.
+	// Clamped well below the uint64 range.
+	const bool bNegative = Value < 0.0;
+	const uint64 Scaled = (uint64)FMath::RoundToDouble(FMath::Min(FMath::Abs(Value) * (double)Scale, 9.0e18));
+	uint64 IntegerPart = Scaled / Scale;
+	const uint64 FractionPart = Scaled % Scale;
+
+	Out.Append(Prefix);
+
+	// Values that round to zero don't get a sign
+	if (Scaled != 0)
 	{
-		return CurrentIndex < Length;
+		if (bNegative)
+		{
+			Out.AppendChar(TEXT('-'));
+		}
+		else if (bAlwaysShowSign)
+		{
+			Out.AppendChar(TEXT('+'));
+		}
 	}
 
-	// Returns the next character in the current logical line.
-	// Newline characters ('\n' and '\r' / "\r\n") are consumed but never returned.
-	bool NextCharacterInLine(int32& OutSourceIndex, TCHAR& OutChar)
+	// Integer digits come out least significant first. 20 digits and 6 separators at most.
+	TCHAR Digits[32];
+	int32 NumChars = 0;
+	int32 NumDigits = 0;
+	do
 	{
-		if (CurrentIndex >= Length)
+		if (bDigitGrouping && NumDigits > 0 && NumDigits % 3 == 0)
 		{
-			return false;
+			Digits[NumChars++] = TEXT(',');
 		}
+		Digits[NumChars++] = (TCHAR)(TEXT('0') + IntegerPart % 10);
+		IntegerPart /= 10;
+		++NumDigits;
+	}
+	while (IntegerPart > 0);
 
-		const TCHAR Ch = Source[CurrentIndex];
+	while (NumChars > 0)
+	{
+		Out.AppendChar(Digits[--NumChars]);
+	}
 
-		// Handle newlines as line separators, not drawable characters.
-		if (Ch == '\n')
+	if (NumDecimals > 0)
+	{
+		Out.AppendChar(TEXT('.'));
+		for (int32 Digit = NumDecimals - 1; Digit >= 0; --Digit)
 		{
-			++CurrentIndex;
-			return false;
+			Out.AppendChar((TCHAR)(TEXT('0') + (FractionPart / PowersOfTen[Digit]) % 10));
 		}
+	}
+
+	Out.Append(Suffix);
+}
+
+// Render thread only: TableId -> shared GPU glyph buffer
+static TMap<uint32, TWeakPtr<FNTTGlyphBuffer>> GNTTGlyphBuffers_RT;
+
+static int32 GNTTAsyncLayoutThreshold = 1024;
+static FAutoConsoleVariableRef CVarNTTAsyncLayoutThreshold(
+	TEXT("ntt.AsyncLayoutThreshold"),
+	GNTTAsyncLayoutThreshold,
+	TEXT("Texts with at least this many characters that aren't in the layout cache are laid out on a worker thread instead of inline.\n")
+	TEXT("The instance reports GetLayoutReady = false until the layout arrives. 0 always lays out inline."),
+	ECVF_Default);
+
+static int32 GNTTMinimalMode = 0;
+static FAutoConsoleVariableRef CVarNTTMinimalMode(
+	TEXT("ntt.MinimalMode"),
+	GNTTMinimalMode,
+	TEXT("Instances in minimal mode skip the font, the layout and all render thread work, and only keep counts if the DI asks for them.\n")
+	TEXT("0: on dedicated servers and without rendering (-nullrhi). 1: always. -1: never. Applies to instances created afterwards."),
+	ECVF_Default);
+
+static bool ShouldUseMinimalMode(const FNiagaraSystemInstance* SystemInstance)
+{
+	if (GNTTMinimalMode != 0)
+	{
+		return GNTTMinimalMode > 0;
+	}
+	if (!FApp::CanEverRender())
+	{
+		return true;
+	}
+	// Dedicated servers started from the editor share the process with clients that render
+	const UWorld* World = SystemInstance ? SystemInstance->GetWorld() : nullptr;
+	return World && World->GetNetMode() == NM_DedicatedServer;
+}
+
+// Stands in for the font of minimal instances, so the VM functions always have a table. Every character maps to the zero glyph.
+static const FNTTGlyphTableRef& GetMinimalGlyphTable()
+{
+	static const FNTTGlyphTableRef Table = []()
+	{
+		TSharedPtr<FNTTGlyphTable, ESPMode::ThreadSafe> EmptyTable = MakeShared<FNTTGlyphTable, ESPMode::ThreadSafe>();
+		EmptyTable->BuildChannels();
+		return FNTTGlyphTableRef(EmptyTable);
+	}();
+	return Table;
+}
+
+FNTTGlyphBufferRef FNTTGlyphBufferRegistry::FindOrCreate_RT(const FNTTGlyphTable& GlyphTable, FRHICommandListBase& RHICmdList)
+{
+	check(IsInRenderingThread());
+	LLM_SCOPE_BYTAG(NTT_GPUBuffers);
 
-		if (Ch == '\r')
+	// A buffer uploaded before ntt.CompactGPUEncoding changed is replaced, instances already using it keep their reference
+	const bool bCompact = NTTPackedEncoding::ShouldUseCompactGlyphs(GlyphTable);
+
+	if (TWeakPtr<FNTTGlyphBuffer>* Existing = GNTTGlyphBuffers_RT.Find(GlyphTable.TableId))
+	{
+		if (FNTTGlyphBufferRef Pinned = Existing->Pin())
 		{
-			// Treat CRLF as a single newline.
-			if (CurrentIndex + 1 < Length && Source[CurrentIndex + 1] == '\n')
-			{
-				CurrentIndex += 2;
-			}
-			else
+			if (Pinned->bCompact == bCompact)
 			{
-				++CurrentIndex;
+				return Pinned;
 			}
-			return false;
 		}
+	}
 
-		OutSourceIndex = CurrentIndex;
-		OutChar = Ch;
-		++CurrentIndex;
-		return true;
+	// Drop entries whose buffers have been released so the map doesn't grow with every font reload.
+	for (auto It = GNTTGlyphBuffers_RT.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
 	}
 
-	// Peek at the next character in the current logical line without advancing.
-	// Returns false at end-of-line or end-of-string.
-	bool PeekNextCharacterInLine(TCHAR& OutChar) const
+	FNTTGlyphBufferRef GlyphBuffer = MakeShared<FNTTGlyphBuffer>();
+	GlyphBuffer->TableId = GlyphTable.TableId;
+	GlyphBuffer->bCompact = bCompact;
+
+	const int32 NumRects = GlyphTable.NumGlyphs();
+	GlyphBuffer->NumRects = (uint32)NumRects;
+	GlyphBuffer->Offset_UVs = 0;
+	GlyphBuffer->Offset_Sizes = NTTPackedEncoding::GetGlyphUVSlots(NumRects, bCompact);
+
+	const uint32 TotalFloats = FMath::Max<uint32>(GlyphBuffer->Offset_Sizes + NTTPackedEncoding::GetGlyphSizeSlots(NumRects, bCompact), 1u);
+
+	GlyphBuffer->Buffer.Initialize(RHICmdList, TEXT("NTT_GlyphBuffer"), sizeof(float), TotalFloats, BUF_ShaderResource | BUF_Static);
+	INC_MEMORY_STAT_BY(STAT_NTT_GlyphBufferMemory, GlyphBuffer->Buffer.NumBytes);
+
+	float* DestInfo = (float*)RHICmdList.LockBuffer(GlyphBuffer->Buffer.Buffer, 0, TotalFloats * sizeof(float), RLM_WriteOnly);
+
+	if (NumRects == 0)
 	{
-		if (CurrentIndex >= Length)
+		DestInfo[0] = 0.0f;
+	}
+
+	// UVs (float4 or 4 x unorm16) and sizes (float2 or half2)
+	NTTPackedEncoding::WriteGlyphUVs(&DestInfo[GlyphBuffer->Offset_UVs], GlyphTable.GlyphTextureUvs, bCompact);
+	NTTPackedEncoding::WriteGlyphSizes(&DestInfo[GlyphBuffer->Offset_Sizes], GlyphTable.GlyphSpriteSizes, bCompact);
+
+	RHICmdList.UnlockBuffer(GlyphBuffer->Buffer.Buffer);
+
+	GNTTGlyphBuffers_RT.Add(GlyphTable.TableId, GlyphBuffer);
+
+	UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI (RT): Created shared glyph buffer for table %u (%d glyphs)"), GlyphTable.TableId, NumRects);
+
+	return GlyphBuffer;
+}
+
+FNTTInstanceRemovalQueue& FNTTInstanceRemovalQueue::Get()
+{
+	static FNTTInstanceRemovalQueue Instance;
+	return Instance;
+}
+
+void FNTTInstanceRemovalQueue::Initialize()
+{
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FNTTInstanceRemovalQueue::Flush);
+}
+
+void FNTTInstanceRemovalQueue::Shutdown()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+	Flush();
+}
+
+void FNTTInstanceRemovalQueue::Enqueue(FNDIFontUVInfoProxy* Proxy, FNiagaraSystemInstanceID InstanceID, int32 Slot)
+{
+	FScopeLock ScopeLock(&Lock);
+	Pending.Add({ Proxy, InstanceID, Slot });
+}
+
+void FNTTInstanceRemovalQueue::Flush()
+{
+	TArray<FRemoval> Removals;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (Pending.Num() == 0)
 		{
-			return false;
+			return;
 		}
+		Removals = MoveTemp(Pending);
+	}
 
-		const TCHAR Ch = Source[CurrentIndex];
-		if (Ch == '\n' || Ch == '\r')
+	ENQUEUE_RENDER_COMMAND(NTTRemoveInstances)
+	(
+		[Removals](FRHICommandListImmediate& RHICmdList)
 		{
-			return false;
+			TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(NTT_RemoveInstances, NTTChannel);
+			for (const FRemoval& Removal : Removals)
+			{
+				Removal.Proxy->RemoveInstance_RT(Removal.InstanceID, Removal.Slot);
+			}
 		}
+	);
 
-		OutChar = Ch;
-		return true;
+	// Anything that claims these slots now reaches the render thread after the removal above
+	for (const FRemoval& Removal : Removals)
+	{
+		Removal.Proxy->FreeSlot_GT(Removal.Slot);
 	}
-};
+}
+
+static int32 GNTTBufferPoolMaxBytes = 16 * 1024 * 1024;
+static FAutoConsoleVariableRef CVarNTTBufferPoolMaxBytes(
+	TEXT("ntt.BufferPool.MaxBytes"),
+	GNTTBufferPoolMaxBytes,
+	TEXT("Upper bound on the bytes of idle NTT text buffers kept on the render thread for reuse. 0 disables pooling."),
+	ECVF_Default);
+
+TGlobalResource<FNTTBufferPool> GNTTBufferPool;
+TGlobalResource<FNTTDefaultBuffers> GNTTDefaultBuffers;
+
+static uint64 MakeBufferPoolKey(uint32 BytesPerElement, uint32 NumElements)
+{
+	return ((uint64)BytesPerElement << 32) | (uint64)NumElements;
+}
+
+FNTTBufferPool::FBufferPtr FNTTBufferPool::Acquire_RT(FRHICommandListBase& RHICmdList, const TCHAR* DebugName, uint32 BytesPerElement, uint32 NumElements)
+{
+	check(IsInRenderingThread());
+
+	const uint32 BucketElements = FMath::RoundUpToPowerOfTwo(FMath::Max(NumElements, 64u));
+	if (TArray<FBufferPtr>* Bucket = FreeBuffers.Find(MakeBufferPoolKey(BytesPerElement, BucketElements)))
+	{
+		if (Bucket->Num() > 0)
+		{
+			FBufferPtr Buffer = Bucket->Pop();
+			FreeBytes -= Buffer->NumBytes;
+			SET_MEMORY_STAT(STAT_NTT_PooledBufferMemory, FreeBytes);
+			return Buffer;
+		}
+	}
+
+	// Static buffers are rewritten through a staging copy on lock, so reuse stays ordered with in-flight GPU reads
+	LLM_SCOPE_BYTAG(NTT_GPUBuffers);
+	FBufferPtr Buffer = MakeUnique<FRWBufferStructured>();
+	Buffer->Initialize(RHICmdList, DebugName, BytesPerElement, BucketElements, BUF_ShaderResource | BUF_Static);
+	INC_MEMORY_STAT_BY(STAT_NTT_TextBufferMemory, Buffer->NumBytes);
+	return Buffer;
+}
+
+void FNTTBufferPool::Release_RT(FBufferPtr& Buffer)
+{
+	check(IsInRenderingThread());
+
+	if (!Buffer.IsValid())
+	{
+		return;
+	}
+
+	if (IsInitialized() && Buffer->Buffer.IsValid() && FreeBytes + Buffer->NumBytes <= (uint64)FMath::Max(GNTTBufferPoolMaxBytes, 0))
+	{
+		const uint32 BytesPerElement = Buffer->Buffer->GetStride();
+		FreeBytes += Buffer->NumBytes;
+		SET_MEMORY_STAT(STAT_NTT_PooledBufferMemory, FreeBytes);
+		FreeBuffers.FindOrAdd(MakeBufferPoolKey(BytesPerElement, Buffer->NumBytes / BytesPerElement)).Add(MoveTemp(Buffer));
+		return;
+	}
+
+	DEC_MEMORY_STAT_BY(STAT_NTT_TextBufferMemory, Buffer->NumBytes);
+	Buffer.Reset();
+}
+
+void FNTTBufferPool::ReleaseRHI()
+{
+	DEC_MEMORY_STAT_BY(STAT_NTT_TextBufferMemory, FreeBytes);
+	SET_MEMORY_STAT(STAT_NTT_PooledBufferMemory, 0);
+	FreeBuffers.Empty();
+	FreeBytes = 0;
+}
+
+void FNTTDefaultBuffers::InitRHI(FRHICommandListBase& RHICmdList)
+{
+	FloatBuffer.Initialize(RHICmdList, TEXT("NTT_Default"), sizeof(float), 4, BUF_ShaderResource | BUF_Static);
+	const float Zeros[4] = { 0, 0, 0, 0 };
+	void* Dest = RHICmdList.LockBuffer(FloatBuffer.Buffer, 0, sizeof(Zeros), RLM_WriteOnly);
+	FMemory::Memcpy(Dest, Zeros, sizeof(Zeros));
+	RHICmdList.UnlockBuffer(FloatBuffer.Buffer);
+
+	// An empty record: no glyph, no line, no word
+	RecordBuffer.Initialize(RHICmdList, TEXT("NTT_DefaultRecords"), sizeof(FUintVector4), 1, BUF_ShaderResource | BUF_Static);
+	const FUintVector4 EmptyRecord(0, 0, 0xFFFFFFFFu, 0xFFFFFFFFu);
+	Dest = RHICmdList.LockBuffer(RecordBuffer.Buffer, 0, sizeof(FUintVector4), RLM_WriteOnly);
+	FMemory::Memcpy(Dest, &EmptyRecord, sizeof(FUintVector4));
+	RHICmdList.UnlockBuffer(RecordBuffer.Buffer);
+}
+
+void FNTTDefaultBuffers::ReleaseRHI()
+{
+	FloatBuffer.Release();
+	RecordBuffer.Release();
+}
 
 const FName UNTTDataInterface::GetCharacterUVName(TEXT("GetCharacterUV"));
 const FName UNTTDataInterface::GetCharacterPositionName(TEXT("GetCharacterPosition"));
@@ -114,472 +358,609 @@ const FName UNTTDataInterface::GetCharacterCountInWordRangeName(TEXT("GetCharact
 const FName UNTTDataInterface::GetCharacterCountInLineRangeName(TEXT("GetCharacterCountInLineRange"));
 const FName UNTTDataInterface::GetCharacterSpriteSizeName(TEXT("GetCharacterSpriteSize"));
 const FName UNTTDataInterface::GetTextHeightName(TEXT("GetTextHeight"));
+const FName UNTTDataInterface::GetTextVersionName(TEXT("GetTextVersion"));
+const FName UNTTDataInterface::GetCharacterLineIndexName(TEXT("GetCharacterLineIndex"));
+const FName UNTTDataInterface::GetCharacterWordIndexName(TEXT("GetCharacterWordIndex"));
+const FName UNTTDataInterface::GetCharacterIndexInLineName(TEXT("GetCharacterIndexInLine"));
+const FName UNTTDataInterface::GetCharacterIndexInWordName(TEXT("GetCharacterIndexInWord"));
+const FName UNTTDataInterface::GetCharacterNormalizedIndexName(TEXT("GetCharacterNormalizedIndex"));
+const FName UNTTDataInterface::GetTextEntryCountName(TEXT("GetTextEntryCount"));
+const FName UNTTDataInterface::GetCharacterEntryName(TEXT("GetCharacterEntry"));
+const FName UNTTDataInterface::GetTextEntryInfoName(TEXT("GetTextEntryInfo"));
+const FName UNTTDataInterface::GetLayoutReadyName(TEXT("GetLayoutReady"));
+const FName UNTTDataInterface::GetWindowFirstLineName(TEXT("GetWindowFirstLine"));
+const FName UNTTDataInterface::GetDocumentLineCountName(TEXT("GetDocumentLineCount"));
 
 // Creates a new data object to store our data
 bool UNTTDataInterface::InitPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(NTTDataInterface_InitPerInstanceData);
+	LLM_SCOPE_BYTAG(NTT);
 
 	FNDIFontUVInfoInstanceData* InstanceData = new (PerInstanceData) FNDIFontUVInfoInstanceData;
-
-	TArray<FVector4> CharacterTextureUvs;
-	TArray<FVector2f> CharacterSpriteSizes;
-	TArray<int32> VerticalOffsets;
-	int32 Kerning = 0;
-	if (!GetFontInfo(FontAsset, CharacterTextureUvs, CharacterSpriteSizes, VerticalOffsets, Kerning))
-	{
-		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT DI: Failed to get font info from FontAsset '%s'"), *GetNameSafe(FontAsset));
-	}
-	
-	float TotalTextHeight = 0.0f;
-	TArray<FVector2f> CharacterPositionsUnfiltered = GetCharacterPositions(CharacterSpriteSizes, VerticalOffsets, Kerning, VerticalOffset, KerningOffset, WhitespaceWidthMultiplier, InputText, HorizontalAlignment, VerticalAlignment, TotalTextHeight);
-	
-	TArray<int32> OutUnicode;
-	TArray<FVector2f> OutCharacterPositions;
-	TArray<int32> OutLineStartIndices;
-	TArray<int32> OutLineCharacterCounts;
-	TArray<int32> OutWordStartIndices;
-	TArray<int32> OutWordCharacterCounts;
-
-	if (CharacterPositionsUnfiltered.Num() == InputText.Len())
-	{
-		ProcessText(InputText, CharacterPositionsUnfiltered, bFilterWhitespaceCharacters, OutUnicode, OutCharacterPositions, OutLineStartIndices, OutLineCharacterCounts, OutWordStartIndices, OutWordCharacterCounts);
-	}
-
-	InstanceData->CharacterTextureUvs = MoveTemp(CharacterTextureUvs);
-	InstanceData->CharacterSpriteSizes = MoveTemp(CharacterSpriteSizes);
-	InstanceData->bFilterWhitespaceCharactersValue = bFilterWhitespaceCharacters;
-	InstanceData->Unicode = MoveTemp(OutUnicode);
-	InstanceData->CharacterPositions = MoveTemp(OutCharacterPositions);
-	InstanceData->LineStartIndices = MoveTemp(OutLineStartIndices);
-	InstanceData->LineCharacterCounts = MoveTemp(OutLineCharacterCounts);
-	InstanceData->WordStartIndices = MoveTemp(OutWordStartIndices);
-	InstanceData->WordCharacterCounts = MoveTemp(OutWordCharacterCounts);
-	InstanceData->TotalTextHeight = TotalTextHeight;
+	NTTStats::OnInstanceCreated(sizeof(FNDIFontUVInfoInstanceData));
+	InstanceData->bMinimal = ShouldUseMinimalMode(SystemInstance);
+	if (!InstanceData->bMinimal)
+	{
+		InstanceData->Slot = GetProxyAs<FNDIFontUVInfoProxy>()->AllocateSlot_GT();
+	}
+	FNTTInstanceRegistry::Get().Register(InstanceData, GetProxyAs<FNDIFontUVInfoProxy>(), SystemInstance->GetId(), this, SystemInstance->GetSystem());
+	UpdateInstanceLayout(*InstanceData);
 
 	return true;
 }
 
-bool UNTTDataInterface::GetFontInfo(const UFont* FontAsset, TArray<FVector4>& OutCharacterTextureUvs, TArray<FVector2f>& OutCharacterSpriteSizes, TArray<int32>& OutVerticalOffsets, int32& OutKerning)
+// Picks up text/font changes made through the setters without reinitializing the system
+bool UNTTDataInterface::PerInstanceTick(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance, float DeltaSeconds)
 {
-	OutCharacterTextureUvs.Reset();
-	OutCharacterSpriteSizes.Reset();
-	OutVerticalOffsets.Reset();
-	OutKerning = 0;
+	FNDIFontUVInfoInstanceData* InstanceData = static_cast<FNDIFontUVInfoInstanceData*>(PerInstanceData);
 
-	// Only offline cached fonts have the Characters array populated
-	if (FontAsset && FontAsset->FontCacheType == EFontCacheType::Offline)
+	if (InstanceData->PendingLayoutTask.IsValid() && InstanceData->PendingLayoutTask.IsCompleted())
 	{
-		// Try to get the first font texture so we can normalize glyph UVs into 0-1 space.
-		const UTexture2D* FontTexture = nullptr;
-		if (FontAsset->Textures.Num() > 0)
-		{
-			FontTexture = Cast<UTexture2D>(FontAsset->Textures[0]);
-		}
-
-		FVector2f InvTextureSize(1.0f, 1.0f);
-		if (FontTexture)
-		{
-			const float TexW = static_cast<float>(FontTexture->GetSizeX());
-			const float TexH = static_cast<float>(FontTexture->GetSizeY());
-			if (TexW > 0.0f && TexH > 0.0f)
-			{
-				InvTextureSize = FVector2f(1.0f / TexW, 1.0f / TexH);
-			}
-			else
-			{
-				UE_LOG(LogNiagaraTextToolkit, Warning,
-					TEXT("NTT DI: Font '%s' texture has invalid size (%f x %f) - UVs will not be normalized"),
-					*GetNameSafe(FontAsset), TexW, TexH);
-			}
-		}
-		else
-		{
-			UE_LOG(LogNiagaraTextToolkit, Warning,
-				TEXT("NTT DI: Font '%s' has no textures - UVs will not be normalized"),
-				*GetNameSafe(FontAsset));
-		}
-
-		// Copy data from FFontCharacter array to our arrays
-		const int32 NumCharacters = FontAsset->Characters.Num();
-		OutCharacterTextureUvs.Reserve(NumCharacters);
-		OutCharacterSpriteSizes.Reserve(NumCharacters);
-		OutVerticalOffsets.Reserve(NumCharacters);
+		FNTTTextLayoutRef Layout = InstanceData->PendingLayoutTask.GetResult();
+		InstanceData->PendingLayoutTask = UE::Tasks::TTask<FNTTTextLayoutRef>();
+		InstanceData->SetLayout(MoveTemp(InstanceData->PendingGlyphTable), MoveTemp(Layout));
+	}
 
-		for (const FFontCharacter& FontChar : FontAsset->Characters)
-		{
-			const float USizePx = static_cast<float>(FontChar.USize);
-			const float VSizePx = static_cast<float>(FontChar.VSize);
-			const float UStartPx = static_cast<float>(FontChar.StartU);
-			const float VStartPx = static_cast<float>(FontChar.StartV);
-
-			// Store sprite size in pixels for layout / particle sizing.
-			OutCharacterSpriteSizes.Add(FVector2f(USizePx, VSizePx));
-
-			// Precompute normalized UVs so shaders/materials don't have to divide by texture resolution.
-			const float USizeNorm  = USizePx  * InvTextureSize.X;
-			const float VSizeNorm  = VSizePx  * InvTextureSize.Y;
-			const float UStartNorm = UStartPx * InvTextureSize.X;
-			const float VStartNorm = VStartPx * InvTextureSize.Y;
-
-			// Layout: (USize, VSize, UStart, VStart) in 0-1 texture space.
-			OutCharacterTextureUvs.Add(FVector4(USizeNorm, VSizeNorm, UStartNorm, VStartNorm));
-			OutVerticalOffsets.Add(FontChar.VerticalOffset);
-		}
+	const double CurrentTime = FApp::GetCurrentTime();
+	if (CurrentTime >= NextTextEntryExpiry.load(std::memory_order_relaxed))
+	{
+		RemoveExpiredTextEntries(CurrentTime);
+	}
 
-		OutKerning = FontAsset->Kerning;
-		return true;
+	if (InstanceData->ParameterRevision != ParameterRevision.load(std::memory_order_acquire))
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(NTTDataInterface_UpdateLayout);
+		LLM_SCOPE_BYTAG(NTT);
+		UpdateInstanceLayout(*InstanceData);
 	}
-	else
+
+	if (InstanceData->EntryPlacements.IsValid())
 	{
-		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT DI: Font '%s' is invalid or not an offline cached font - Characters array will be empty"), *GetNameSafe(FontAsset));
-		return false;
+		InstanceData->EntryClock = (float)(CurrentTime - InstanceData->EntryPlacements->EntryClockBase);
 	}
+
+	CSV_CUSTOM_STAT(NTT, LiveInstances, NTTStats::GetNumLiveInstances(), ECsvCustomStatOp::Set);
+
+	// The new layout is swapped in place and sent to the render thread with the next frame's data, so never ask for a reinit.
+	return false;
 }
 
-TArray<FVector2f> UNTTDataInterface::GetCharacterPositions(const TArray<FVector2f>& CharacterSpriteSizes, const TArray<int32>& VerticalOffsets, int32 Kerning, float ExtraVerticalOffset, float ExtraKerningOffset, float WhitespaceWidthMultiplier, FString InputString, ENTTTextHorizontalAlignment XAlignment, ENTTTextVerticalAlignment YAlignment, float& OutTotalHeight)
+void UNTTDataInterface::UpdateInstanceLayout(FNDIFontUVInfoInstanceData& InstanceData) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_NTT_TextProcessing);
+	CSV_SCOPED_TIMING_STAT(NTT, TextProcessing);
+	INC_DWORD_STAT(STAT_NTT_LayoutUpdates);
+
+	FNTTNumericTextBuilder NumericText;
+	const FNTTLayoutParams Params = GetLayoutParams(&NumericText, &InstanceData.StreamingWindowText);
+	const FStringView Text = Params.bNumericText ? NumericText.ToView() : Params.bWindowText ? FStringView(InstanceData.StreamingWindowText) : FStringView(Params.InputText);
+
+	// Whatever is built below supersedes a layout still in flight
+	InstanceData.PendingLayoutTask = UE::Tasks::TTask<FNTTTextLayoutRef>();
+	InstanceData.PendingGlyphTable.Reset();
+	if (!Params.bMultiText)
+	{
+		InstanceData.EntryLayouts.Empty();
+		InstanceData.SetEntryPlacements(nullptr);
+	}
 
-	TArray<FVector2f> CharacterPositionsUnfiltered;
-	OutTotalHeight = 0.0f;
-
-	const int32 TextLength = InputString.Len();
-	if (TextLength <= 0 || CharacterSpriteSizes.Num() == 0)
+	// Nothing is drawn, so the font is never touched and at most the counts are built
+	if (InstanceData.bMinimal)
 	{
-		return CharacterPositionsUnfiltered;
+		if (Params.bMultiText && bCountsInMinimalMode)
+		{
+			UpdateMultiTextLayout(InstanceData, GetMinimalGlyphTable(), Params);
+			return;
+		}
+		UpdateMinimalLayout(InstanceData, Params, Text);
+		return;
 	}
 
-	// Initialize to (0,0) so that indices for newline characters
-	// are still valid when later indexed by the text processing passes.
-	CharacterPositionsUnfiltered.Init(FVector2f(0.0f, 0.0f), TextLength);
+	// Glyph tables are shared between every instance using the same font, so this is a cache lookup after the first spawn.
+	FNTTGlyphTableRef GlyphTable = FNTTFontGlyphCache::Get().FindOrBuild(Params.FontAsset);
+	if (!GlyphTable->IsValid())
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT DI: Failed to get font info from FontAsset '%s'"), *GetNameSafe(Params.FontAsset));
+	}
 
-	// Global fallback line height in case a line has no drawable characters.
-	float GlobalMaxGlyphHeight = 0.0f;
-	for (const FVector2f& Size : CharacterSpriteSizes)
+	if (Params.bMultiText)
 	{
-		GlobalMaxGlyphHeight = FMath::Max(GlobalMaxGlyphHeight, Size.Y);
+		UpdateMultiTextLayout(InstanceData, MoveTemp(GlyphTable), Params);
+		return;
 	}
 
-	const float CharIncrement = static_cast<float>(Kerning) + ExtraKerningOffset; // No extra horizontal spacing in this data interface.
+	if (Params.bNumericText || Params.bStreaming)
+	{
+		// Numbers and streaming windows change too often to be worth caching. They rotate through layouts the render thread
+		// has let go of, so their arrays are reused instead of reallocated.
+		TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> Layout = InstanceData.ClaimReusableLayout();
+		FNTTTextLayoutEngine::Build(*GlyphTable, Params, Text, *Layout);
+
+		InstanceData.ParameterRevision = Params.Revision;
+		InstanceData.SetLayout(MoveTemp(GlyphTable), MoveTemp(Layout));
+		return;
+	}
 
-	// Per-line widths, heights, and tops
-	// tops are aligned at 0, so the top of the first line is at 0, and the top of the second line is the height of the first line, etc.
-	TArray<float> LineWidths;
-	TArray<float> LineHeights;
-	TArray<float> LineTops;
-	float TotalHeight = 0.0f;
+	// Identical text/font/settings share one immutable layout, so repeated spawns are a cache hit.
+	const bool bAsync = GNTTAsyncLayoutThreshold > 0 && Params.InputText.Len() >= GNTTAsyncLayoutThreshold;
+	FNTTTextLayoutRef Layout = bAsync ? FNTTLayoutCache::Get().Find(*GlyphTable, Params) : FNTTLayoutCache::Get().FindOrBuild(*GlyphTable, Params);
 
-	FNTTTextIterator It(InputString);
+	InstanceData.ParameterRevision = Params.Revision;
 
-	while (It.HasNextCharacter())
+	if (!Layout.IsValid())
 	{
-		float LineX = 0.0f;
-		float MaxBottom = 0.0f;
-
-		int32 SourceIndex = INDEX_NONE;
-		TCHAR Ch = 0;
+		// Long texts are laid out on a worker so activation doesn't hitch. Until the first layout arrives the instance
+		// has no characters; when the text changes the previous layout stays up until the new one replaces it.
+		InstanceData.PendingGlyphTable = GlyphTable;
+		InstanceData.PendingLayoutTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [GlyphTable, Params]()
+		{
+			LLM_SCOPE_BYTAG(NTT);
+			FNTTTextLayoutRef AsyncLayout = BuildLayout(*GlyphTable, Params);
+			FNTTLayoutCache::Get().Add(*GlyphTable, Params, AsyncLayout);
+			return AsyncLayout;
+		});
 
-		while (It.NextCharacterInLine(SourceIndex, Ch))
+		if (!InstanceData.Layout.IsValid())
 		{
-			const int32 Code = static_cast<int32>(Ch);
+			static const FNTTTextLayoutRef EmptyLayout = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>();
+			InstanceData.SetLayout(MoveTemp(GlyphTable), EmptyLayout);
+		}
+		return;
+	}
 
-			// Skip characters that do not have glyph data. (positions will be set to 0,0)
-			if (!CharacterSpriteSizes.IsValidIndex(Code) || !VerticalOffsets.IsValidIndex(Code))
-			{
-				continue;
-			}
+	InstanceData.SetLayout(MoveTemp(GlyphTable), MoveTemp(Layout));
+}
 
-			const FVector2f& GlyphSize = CharacterSpriteSizes[Code];
+void UNTTDataInterface::UpdateMultiTextLayout(FNDIFontUVInfoInstanceData& InstanceData, FNTTGlyphTableRef GlyphTable, const FNTTLayoutParams& Params) const
+{
+	// Entry that has no layout for the current settings yet
+	struct FMissingLayout
+	{
+		int32 PartIndex = 0;
+		int32 EntryIndex = 0;
+		int32 Serial = 0;
+		uint32 TextVersion = 0;
+		FString Text;
+	};
 
-			float SizeX = GlyphSize.X;
-			const float SizeY = GlyphSize.Y;
-			const float TopY  = static_cast<float>(VerticalOffsets[Code]); // how far from the line's origin its top is
+	// Params has no text in multi-text mode, so this only holds the glyph table and settings
+	const FNTTLayoutCacheKey EntrySettings(*GlyphTable, Params);
 
-			if (IsWhitespaceChar(Code))
+	TArray<FNTTTextLayoutRef> Parts;
+	TArray<FMissingLayout> Missing;
+	TSharedPtr<FNTTEntryPlacements, ESPMode::ThreadSafe> Placements = MakeShared<FNTTEntryPlacements, ESPMode::ThreadSafe>();
+	{
+		FScopeLock Lock(&ParameterLock);
+
+		if (!(TextEntryLayoutsKey == EntrySettings))
+		{
+			TextEntryLayoutsKey = EntrySettings;
+			for (const FTextEntry& Entry : TextEntries)
 			{
-				SizeX *= WhitespaceWidthMultiplier;
+				Entry.Layout.Reset();
 			}
+		}
 
-			const float BottomY = TopY + SizeY; // how far from the line's origin its bottom is
-			MaxBottom = FMath::Max(MaxBottom, BottomY);
-
-			LineX += SizeX;
+		Parts.Reserve(TextEntries.Num());
+		Placements->EntryOrigins.Reserve(TextEntries.Num());
+		Placements->EntryTimes.Reserve(TextEntries.Num());
+		Placements->EntryClockBase = TextEntryClockBase;
 
-			// If we have another non-whitespace character on this line, add kerning.
-			TCHAR NextCh = 0;
-			if (It.PeekNextCharacterInLine(NextCh) && !FChar::IsWhitespace(NextCh))
+		// Only the text of entries that were never laid out with these settings is copied
+		for (auto It = TextEntries.CreateConstIterator(); It; ++It)
+		{
+			if (!It->Layout.IsValid())
 			{
-				LineX += CharIncrement;
+				FMissingLayout& MissingLayout = Missing.AddDefaulted_GetRef();
+				MissingLayout.PartIndex = Parts.Num();
+				MissingLayout.EntryIndex = It.GetIndex();
+				MissingLayout.Serial = It->Serial;
+				MissingLayout.TextVersion = It->TextVersion;
+				MissingLayout.Text = It->Text;
 			}
+			Parts.Add(It->Layout);
+			Placements->EntryOrigins.Add(It->Origin);
+			Placements->EntryTimes.Add(FVector2f((float)(It->AddTime - TextEntryClockBase), It->Lifetime));
 		}
+	}
 
-		LineWidths.Add(LineX);
-
-		const float LineHeight = (MaxBottom > 0.0f) ? MaxBottom : GlobalMaxGlyphHeight;
-		LineHeights.Add(LineHeight);
-		LineTops.Add(TotalHeight);
-		TotalHeight += LineHeight;
+	if (Missing.Num() > 0)
+	{
+		// New entries go through the layout cache on their own, so repeated strings (damage numbers) are laid out once
+		FNTTLayoutParams EntryParams = Params;
+		for (FMissingLayout& MissingLayout : Missing)
+		{
+			if (InstanceData.bMinimal)
+			{
+				TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> Part = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>();
+				FNTTTextLayoutEngine::BuildCounts(Params, MissingLayout.Text, *Part);
+				Parts[MissingLayout.PartIndex] = MoveTemp(Part);
+				continue;
+			}
+			EntryParams.InputText = MoveTemp(MissingLayout.Text);
+			Parts[MissingLayout.PartIndex] = FNTTLayoutCache::Get().FindOrBuild(*GlyphTable, EntryParams);
+		}
 
-		if (It.HasNextCharacter())
+		FScopeLock Lock(&ParameterLock);
+		if (TextEntryLayoutsKey == EntrySettings)
 		{
-			TotalHeight += ExtraVerticalOffset;
+			for (const FMissingLayout& MissingLayout : Missing)
+			{
+				// Entries removed or given a new text in the meantime keep waiting for their own layout
+				if (TextEntries.IsValidIndex(MissingLayout.EntryIndex)
+					&& TextEntries[MissingLayout.EntryIndex].Serial == MissingLayout.Serial
+					&& TextEntries[MissingLayout.EntryIndex].TextVersion == MissingLayout.TextVersion)
+				{
+					TextEntries[MissingLayout.EntryIndex].Layout = Parts[MissingLayout.PartIndex];
+				}
+			}
 		}
 	}
-	
-	OutTotalHeight = TotalHeight;
 
-	// if there are no lines, return an array of all zeros (in the case where all characters are newlines)
-	const int32 NumLines = LineWidths.Num();
-	if (NumLines == 0)
+	InstanceData.ParameterRevision = Params.Revision;
+	InstanceData.SetEntryPlacements(MoveTemp(Placements));
+
+	// Same entry layouts in the same order: only origins or times changed, and the layout and its GPU buffer are kept
+	if (InstanceData.Layout.IsValid() && InstanceData.GlyphTable == GlyphTable && InstanceData.EntryLayouts == Parts)
 	{
-		return CharacterPositionsUnfiltered;
+		return;
 	}
 
-	// Vertical alignment: decide where the block of text is placed relative to Y=0.
-	float VerticalOffset = 0.0f;
-	switch (YAlignment)
+	TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> Layout = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>();
+	FNTTTextLayoutEngine::Combine(Parts, *Layout);
+	Layout->bFilterWhitespaceCharactersValue = Params.bFilterWhitespaceCharacters;
+
+	InstanceData.EntryLayouts = MoveTemp(Parts);
+	InstanceData.SetLayout(MoveTemp(GlyphTable), MoveTemp(Layout));
+}
+
+void UNTTDataInterface::UpdateMinimalLayout(FNDIFontUVInfoInstanceData& InstanceData, const FNTTLayoutParams& Params, FStringView Text) const
+{
+	InstanceData.ParameterRevision = Params.Revision;
+
+	static const FNTTTextLayoutRef EmptyLayout = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>();
+	if (!bCountsInMinimalMode)
 	{
-		case ENTTTextVerticalAlignment::NTT_TVA_Top:
+		if (InstanceData.Layout != EmptyLayout)
 		{
-			// Top of first line at Y=0.
-			VerticalOffset = 0.0f;
-			break;
-		}
-		case ENTTTextVerticalAlignment::NTT_TVA_Center:
-		{
-			// Center of the whole block at Y=0.
-			VerticalOffset = -(TotalHeight * 0.5f);
-			break;
-		}
-		case ENTTTextVerticalAlignment::NTT_TVA_Bottom:
-		{
-			// Bottom of the last line at Y=0.
-			VerticalOffset = -TotalHeight;
-			break;
-		}
-		default:
-		{
-			break;
+			InstanceData.SetLayout(GetMinimalGlyphTable(), EmptyLayout);
 		}
+		return;
 	}
 
-	// Horizontal alignment: compute per-line starting X.
-	TArray<float> LineStartX;
-	LineStartX.SetNum(NumLines);
+	TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> Layout = InstanceData.ClaimReusableLayout();
+	FNTTTextLayoutEngine::BuildCounts(Params, Text, *Layout);
+	InstanceData.SetLayout(GetMinimalGlyphTable(), MoveTemp(Layout));
+}
+
+FNTTTextLayoutRef UNTTDataInterface::BuildLayout(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params)
+{
+	TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> Layout = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>();
+
+	FNTTTextLayoutEngine::Build(GlyphTable, Params, Params.InputText, *Layout);
 
-	for (int32 LineIdx = 0; LineIdx < NumLines; ++LineIdx)
+	return Layout;
+}
+
+FNTTLayoutParams UNTTDataInterface::GetLayoutParams(FNTTNumericTextBuilder* OutNumericText, FString* OutWindowText) const
+{
+	FScopeLock Lock(&ParameterLock);
+
+	FNTTLayoutParams Params;
+	Params.FontAsset = FontAsset;
+	if (bMultiTextMode)
+	{
+		Params.bMultiText = true;
+	}
+	else if (bStreamingMode && !bNumericMode)
 	{
-		const float Width = LineWidths[LineIdx];
-		float StartX = 0.0f;
+		// Only the lines inside the window are copied out of the document
+		UpdateStreamingLineStartsLocked();
 
-		switch (XAlignment)
+		const int32 NumDocumentLines = StreamingLineStarts.Num();
+		const int32 FirstLine = FMath::Clamp(StreamingScrollLine, 0, NumDocumentLines - 1);
+		const int32 EndLine = FMath::Min(FirstLine + FMath::Max(StreamingWindowLines, 1), NumDocumentLines);
+
+		// The window keeps the line break that ends its last line: the layout engine doesn't start a line after a trailing
+		// break, and empty lines before it are kept.
+		const int32 WindowStart = StreamingLineStarts[FirstLine];
+		const int32 WindowEnd = (EndLine < NumDocumentLines) ? StreamingLineStarts[EndLine] : InputText.Len();
+		const FStringView Window = FStringView(InputText).Mid(WindowStart, WindowEnd - WindowStart);
+
+		if (OutWindowText)
 		{
-			case ENTTTextHorizontalAlignment::NTT_THA_Left:
-			{
-				StartX = 0.0f;
-				break;
-			}
-			case ENTTTextHorizontalAlignment::NTT_THA_Center:
-			{
-				StartX = -Width * 0.5f;
-				break;
-			}
-			case ENTTTextHorizontalAlignment::NTT_THA_Right:
-			{
-				StartX = -Width;
-				break;
-			}
-			default:
-			{
-				break;
-			}
+			// Keeps the buffer's capacity, so scrolling only allocates while windows keep getting longer
+			OutWindowText->Reset(Window.Len());
+			OutWindowText->Append(Window.GetData(), Window.Len());
+			Params.bWindowText = true;
 		}
-
-		LineStartX[LineIdx] = StartX;
+		else
+		{
+			Params.InputText = FString(Window);
+		}
+		Params.bStreaming = true;
+		Params.WindowFirstLine = FirstLine;
+		Params.DocumentLineCount = NumDocumentLines;
+	}
+	else if (!bNumericMode)
+	{
+		Params.InputText = InputText;
+	}
+	else if (OutNumericText)
+	{
+		NumericFormat.Append(*OutNumericText, NumericValue);
+		Params.bNumericText = true;
+	}
+	else
+	{
+		FNTTNumericTextBuilder Formatted;
+		NumericFormat.Append(Formatted, NumericValue);
+		Params.InputText = Formatted.ToView();
 	}
+	Params.HorizontalAlignment = HorizontalAlignment;
+	Params.VerticalAlignment = VerticalAlignment;
+	Params.VerticalOffset = VerticalOffset;
+	Params.KerningOffset = KerningOffset;
+	Params.WhitespaceWidthMultiplier = WhitespaceWidthMultiplier;
+	Params.bFilterWhitespaceCharacters = bFilterWhitespaceCharacters;
+	Params.Revision = ParameterRevision.load(std::memory_order_acquire);
+	return Params;
+}
 
-	// Second pass: assign a position to each character index in the original string,
-	// walking the text again line-by-line using the iterator.
-	FNTTTextIterator It2(InputString);
+void UNTTDataInterface::SetInputText(const FString& NewText)
+{
+	FScopeLock Lock(&ParameterLock);
+	InputText = NewText;
+	// Otherwise the number or the entries would keep hiding the new text, e.g. when the text pool reuses a system that
+	// showed a counter. Entries are kept for the next AddTextEntry.
+	bNumericMode = false;
+	bMultiTextMode = false;
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+}
 
-	for (int32 LineIdx = 0; LineIdx < NumLines && It2.HasNextCharacter(); ++LineIdx)
-	{
-		float LineX = 0.0f;
-		const float LineTop = LineTops[LineIdx] + VerticalOffset;
+void UNTTDataInterface::SetFontAsset(UFont* NewFont)
+{
+	FScopeLock Lock(&ParameterLock);
+	FontAsset = NewFont;
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+}
 
-		int32 SourceIndex = INDEX_NONE;
-		TCHAR Ch = 0;
+void UNTTDataInterface::SetNumericValue(double NewValue)
+{
+	FScopeLock Lock(&ParameterLock);
+	if (bNumericMode && NumericValue == NewValue)
+	{
+		return;
+	}
+	bNumericMode = true;
+	NumericValue = NewValue;
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+}
 
-		while (It2.NextCharacterInLine(SourceIndex, Ch))
-		{
-			const int32 Code = static_cast<int32>(Ch);
+void UNTTDataInterface::SetNumericFormat(const FNTTNumericFormat& NewFormat)
+{
+	FScopeLock Lock(&ParameterLock);
+	NumericFormat = NewFormat;
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+}
 
-			// Skip characters that do not have glyph data. (positions will be set to 0,0)
-			if (!CharacterSpriteSizes.IsValidIndex(Code) || !VerticalOffsets.IsValidIndex(Code))
-			{
-				continue;
-			}
+FNTTTextEntryHandle UNTTDataInterface::AddTextEntry(const FString& Text, FVector Origin, float Lifetime)
+{
+	FScopeLock Lock(&ParameterLock);
 
-			const FVector2f& GlyphSize = CharacterSpriteSizes[Code];
+	const double CurrentTime = FApp::GetCurrentTime();
+	if (TextEntries.Num() == 0)
+	{
+		// Keeps entry times small enough for float precision on the GPU
+		TextEntryClockBase = CurrentTime;
+	}
 
-			float SizeX = GlyphSize.X;
-			const float SizeY = GlyphSize.Y;
-			const float TopY  = static_cast<float>(VerticalOffsets[Code]);
+	FTextEntry NewEntry;
+	NewEntry.Text = Text;
+	NewEntry.Origin = FVector3f(Origin);
+	NewEntry.AddTime = CurrentTime;
+	NewEntry.Lifetime = FMath::Max(Lifetime, 0.0f);
+	NewEntry.Serial = NextTextEntrySerial++;
 
-			if (IsWhitespaceChar(Code))
-			{
-				SizeX *= WhitespaceWidthMultiplier;
-			}
+	FNTTTextEntryHandle Handle;
+	Handle.Serial = NewEntry.Serial;
+	Handle.Index = TextEntries.Add(MoveTemp(NewEntry));
 
-			const float GlyphLeft = LineStartX[LineIdx] + LineX;
-			const float GlyphTop  = LineTop + TopY;
+	if (Lifetime > 0.0f && CurrentTime + Lifetime < NextTextEntryExpiry.load(std::memory_order_relaxed))
+	{
+		NextTextEntryExpiry.store(CurrentTime + Lifetime, std::memory_order_relaxed);
+	}
 
-			const float PosX = GlyphLeft + SizeX * 0.5f;
-			const float PosY = GlyphTop + SizeY * 0.5f;
+	bMultiTextMode = true;
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+	return Handle;
+}
 
-			CharacterPositionsUnfiltered[SourceIndex] = FVector2f(PosX, PosY);
+bool UNTTDataInterface::RemoveTextEntry(FNTTTextEntryHandle Handle)
+{
+	FScopeLock Lock(&ParameterLock);
+	if (FindTextEntryLocked(Handle) == nullptr)
+	{
+		return false;
+	}
 
-			LineX += SizeX;
+	TextEntries.RemoveAt(Handle.Index);
+	UpdateNextTextEntryExpiryLocked();
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+	return true;
+}
 
-			// Apply kerning based on the next character in this logical line, if any.
-			TCHAR NextCh = 0;
-			if (It2.PeekNextCharacterInLine(NextCh) && !FChar::IsWhitespace(NextCh))
-			{
-				LineX += CharIncrement;
-			}
-		}
+bool UNTTDataInterface::SetTextEntryText(FNTTTextEntryHandle Handle, const FString& NewText)
+{
+	FScopeLock Lock(&ParameterLock);
+	FTextEntry* Entry = FindTextEntryLocked(Handle);
+	if (Entry == nullptr)
+	{
+		return false;
 	}
 
-	return CharacterPositionsUnfiltered;
+	Entry->Text = NewText;
+	Entry->Layout.Reset();
+	++Entry->TextVersion;
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+	return true;
 }
 
-void UNTTDataInterface::ProcessText(
-	const FString& InputText,
-	const TArray<FVector2f>& CharacterPositionsUnfiltered,
-	const bool bFilterWhitespace,
-	TArray<int32>& OutUnicode,
-	TArray<FVector2f>& OutCharacterPositions,
-	TArray<int32>& OutLineStartIndices,
-	TArray<int32>& OutLineCharacterCounts,
-	TArray<int32>& OutWordStartIndices,
-	TArray<int32>& OutWordCharacterCounts)
+bool UNTTDataInterface::SetTextEntryOrigin(FNTTTextEntryHandle Handle, FVector NewOrigin)
 {
-	OutUnicode.Reset();
-	OutCharacterPositions.Reset();
-	OutLineStartIndices.Reset();
-	OutWordStartIndices.Reset();
-	OutWordCharacterCounts.Reset();
+	FScopeLock Lock(&ParameterLock);
+	FTextEntry* Entry = FindTextEntryLocked(Handle);
+	if (Entry == nullptr)
+	{
+		return false;
+	}
 
-	// First line always starts at index 0.
-	OutLineStartIndices.Add(0);
+	Entry->Origin = FVector3f(NewOrigin);
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+	return true;
+}
 
-	OutUnicode.Reserve(InputText.Len());
-	OutCharacterPositions.Reserve(InputText.Len());
+void UNTTDataInterface::ClearTextEntries()
+{
+	FScopeLock Lock(&ParameterLock);
+	TextEntries.Empty();
+	NextTextEntryExpiry.store(TNumericLimits<double>::Max(), std::memory_order_relaxed);
+	ParameterRevision.fetch_add(1, std::memory_order_release);
+}
 
-	FNTTTextIterator It(InputText);
+int32 UNTTDataInterface::GetNumTextEntries() const
+{
+	FScopeLock Lock(&ParameterLock);
+	return TextEntries.Num();
+}
 
-	bool bInsideWord = false;
-	int32 CurrentWordStartIndex = -1;
-	int32 CurrentWordCharCount = 0;
+bool UNTTDataInterface::RemoveExpiredTextEntries(double CurrentTime)
+{
+	FScopeLock Lock(&ParameterLock);
 
-	while (It.HasNextCharacter())
+	bool bRemovedAny = false;
+	for (auto It = TextEntries.CreateIterator(); It; ++It)
 	{
-		int32 SourceIndex = INDEX_NONE;
-		TCHAR Ch = 0;
-
-		while (It.NextCharacterInLine(SourceIndex, Ch))
+		if (It->Lifetime > 0.0f && CurrentTime >= It->AddTime + It->Lifetime)
 		{
-			const int32 Code = static_cast<int32>(Ch);
-			const bool bIsWhitespace = IsWhitespaceChar(Code);
+			It.RemoveCurrent();
+			bRemovedAny = true;
+		}
+	}
 
-			// Handle word state transitions
-			if (bIsWhitespace)
-			{
-				if (bInsideWord)
-				{
-					bInsideWord = false;
-					OutWordStartIndices.Add(CurrentWordStartIndex);
-					OutWordCharacterCounts.Add(CurrentWordCharCount);
-				}
-			}
-			else
-			{
-				if (!bInsideWord)
-				{
-					bInsideWord = true;
-					CurrentWordStartIndex = OutUnicode.Num();
-					CurrentWordCharCount = 0;
-				}
-				CurrentWordCharCount++;
-			}
+	UpdateNextTextEntryExpiryLocked();
+	if (bRemovedAny)
+	{
+		ParameterRevision.fetch_add(1, std::memory_order_release);
+	}
+	return bRemovedAny;
+}
 
-			// Filter logic: if filtering is on and it's whitespace, skip output.
-			if (bFilterWhitespace && bIsWhitespace)
-			{
-				continue;
-			}
+UNTTDataInterface::FTextEntry* UNTTDataInterface::FindTextEntryLocked(FNTTTextEntryHandle Handle)
+{
+	if (Handle.IsValid() && TextEntries.IsValidIndex(Handle.Index) && TextEntries[Handle.Index].Serial == Handle.Serial)
+	{
+		return &TextEntries[Handle.Index];
+	}
+	return nullptr;
+}
 
-			// Add to output
-			OutUnicode.Add(Code);
-			OutCharacterPositions.Add(CharacterPositionsUnfiltered[SourceIndex]);
+void UNTTDataInterface::UpdateNextTextEntryExpiryLocked()
+{
+	double NextExpiry = TNumericLimits<double>::Max();
+	for (const FTextEntry& Entry : TextEntries)
+	{
+		if (Entry.Lifetime > 0.0f)
+		{
+			NextExpiry = FMath::Min(NextExpiry, Entry.AddTime + Entry.Lifetime);
 		}
+	}
+	NextTextEntryExpiry.store(NextExpiry, std::memory_order_relaxed);
+}
 
-		// End of logical line. Check if there is another line following (meaning we consumed a newline).
-		if (It.HasNextCharacter())
-		{
-			// Newline breaks word in both modes.
-			if (bInsideWord)
-			{
-				bInsideWord = false;
-				OutWordStartIndices.Add(CurrentWordStartIndex);
-				OutWordCharacterCounts.Add(CurrentWordCharCount);
-			}
+void UNTTDataInterface::SetStreamingScrollLine(int32 NewScrollLine)
+{
+	FScopeLock Lock(&ParameterLock);
+	NewScrollLine = FMath::Max(NewScrollLine, 0);
+	if (StreamingScrollLine == NewScrollLine)
+	{
+		return;
+	}
 
-			// Mark the start of the next line
-			OutLineStartIndices.Add(OutUnicode.Num());
-		}
+	StreamingScrollLine = NewScrollLine;
+	const uint32 PreviousRevision = ParameterRevision.fetch_add(1, std::memory_order_release);
+
+	// Scrolling doesn't touch the text, so the line starts stay valid for the new revision
+	if (StreamingLineStartsRevision == PreviousRevision)
+	{
+		StreamingLineStartsRevision = PreviousRevision + 1;
 	}
+}
+
+int32 UNTTDataInterface::GetDocumentLineCount() const
+{
+	FScopeLock Lock(&ParameterLock);
+	UpdateStreamingLineStartsLocked();
+	return StreamingLineStarts.Num();
+}
 
-	if (bInsideWord)
+void UNTTDataInterface::UpdateStreamingLineStartsLocked() const
+{
+	const uint32 Revision = ParameterRevision.load(std::memory_order_acquire);
+	if (StreamingLineStarts.Num() > 0 && StreamingLineStartsRevision == Revision)
 	{
-		OutWordStartIndices.Add(CurrentWordStartIndex);
-		OutWordCharacterCounts.Add(CurrentWordCharCount);
+		return;
 	}
 
-	// Derive per-line character counts from the line start indices.
-	OutLineCharacterCounts.Reset();
-	OutLineCharacterCounts.Reserve(OutLineStartIndices.Num());
-	for (int32 LineIdx = 0; LineIdx < OutLineStartIndices.Num(); ++LineIdx)
+	// Same line breaks as the layout engine: \n, \r and \r\n
+	StreamingLineStarts.Reset();
+	StreamingLineStarts.Add(0);
+
+	const TCHAR* Chars = *InputText;
+	const int32 TextLength = InputText.Len();
+	for (int32 Index = 0; Index < TextLength; ++Index)
 	{
-		if (LineIdx < OutLineStartIndices.Num() - 1)
+		if (Chars[Index] == '\r' && Index + 1 < TextLength && Chars[Index + 1] == '\n')
 		{
-			OutLineCharacterCounts.Add(OutLineStartIndices[LineIdx + 1] - OutLineStartIndices[LineIdx]);
+			++Index;
 		}
-		else
+		if (Chars[Index] == '\n' || Chars[Index] == '\r')
 		{
-			OutLineCharacterCounts.Add(OutUnicode.Num() - OutLineStartIndices[LineIdx]);
+			StreamingLineStarts.Add(Index + 1);
 		}
 	}
+
+	StreamingLineStartsRevision = Revision;
+}
+
+void UNTTDataInterface::MarkLayoutDirty()
+{
+	ParameterRevision.fetch_add(1, std::memory_order_release);
 }
 
 // Clean up RT instances
 void UNTTDataInterface::DestroyPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance)
 {
 	FNDIFontUVInfoInstanceData* InstanceData = static_cast<FNDIFontUVInfoInstanceData*>(PerInstanceData);
+
+	// Removed on the render thread with every other instance destroyed this frame
+	if (InstanceData->Slot != INDEX_NONE)
+	{
+		FNTTInstanceRemovalQueue::Get().Enqueue(GetProxyAs<FNDIFontUVInfoProxy>(), SystemInstance->GetId(), InstanceData->Slot);
+	}
+	FNTTInstanceRegistry::Get().Unregister(InstanceData);
+
 	InstanceData->~FNDIFontUVInfoInstanceData();
+	NTTStats::OnInstanceDestroyed(sizeof(FNDIFontUVInfoInstanceData));
+}
 
-	ENQUEUE_RENDER_COMMAND(RemoveProxy)
-	(
-		[RT_Proxy = GetProxyAs<FNDIFontUVInfoProxy>(), InstanceID = SystemInstance->GetId()](FRHICommandListImmediate& CmdList)
-		{
-			if (FNDIFontUVInfoProxy::FRTInstanceData* Found = RT_Proxy->SystemInstancesToInstanceData_RT.Find(InstanceID))
-			{
-				Found->Release();
-			}
-			RT_Proxy->SystemInstancesToInstanceData_RT.Remove(InstanceID);
-			UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI (RT): Removed InstanceID=%llu from RT map"), (uint64)InstanceID);
-		}
-	);
+void UNTTDataInterface::BeginDestroy()
+{
+	// Queued removals reference the proxy, which Super releases
+	FNTTInstanceRemovalQueue::Get().Flush();
+
+	Super::BeginDestroy();
 }
 
 int32 UNTTDataInterface::PerInstanceDataSize() const
@@ -607,7 +988,7 @@ void UNTTDataInterface::PostInitProperties()
 	{
 		ENiagaraTypeRegistryFlags Flags = ENiagaraTypeRegistryFlags::AllowAnyVariable | ENiagaraTypeRegistryFlags::AllowParameter;
 		FNiagaraTypeRegistry::Register(FNiagaraTypeDefinition(GetClass()), Flags);
-		UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: Registered type with Niagara Type Registry"));
+		UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI: Registered type with Niagara Type Registry"));
 	}
 }
 
@@ -629,7 +1010,7 @@ void UNTTDataInterface::GetFunctions(TArray<FNiagaraFunctionSignature>& OutFunct
 	SigUVRectAtIndex.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("VStart")), LOCTEXT("VStartDescription", "The starting V coordinate of the character UV rect"));
 	OutFunctions.Add(SigUVRectAtIndex);
 
-	UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetFunctions - Registered function '%s' with 1 input (index) and 4 outputs."),
+	UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI: GetFunctions - Registered function '%s' with 1 input (index) and 4 outputs."),
 		*GetCharacterUVName.ToString());
 
 	// Register GetCharacterPosition
@@ -772,6 +1153,152 @@ void UNTTDataInterface::GetFunctions(TArray<FNiagaraFunctionSignature>& OutFunct
 	SigTextHeight.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
 	SigTextHeight.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("TextHeight")));
 	OutFunctions.Add(SigTextHeight);
+
+	// Register GetTextVersion
+	FNiagaraFunctionSignature SigTextVersion;
+	SigTextVersion.Name = GetTextVersionName;
+#if WITH_EDITORONLY_DATA
+	SigTextVersion.Description = LOCTEXT("GetTextVersionDesc", "Returns a number that changes every time the text or font of this instance is updated. Compare against a stored value to detect live text changes.");
+#endif
+	SigTextVersion.bMemberFunction = true;
+	SigTextVersion.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigTextVersion.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("TextVersion")));
+	OutFunctions.Add(SigTextVersion);
+
+	// Register GetCharacterLineIndex
+	FNiagaraFunctionSignature SigCharLineIndex;
+	SigCharLineIndex.Name = GetCharacterLineIndexName;
+#if WITH_EDITORONLY_DATA
+	SigCharLineIndex.Description = LOCTEXT("GetCharacterLineIndexDesc", "Returns the index of the line the character at CharacterIndex belongs to.");
+#endif
+	SigCharLineIndex.bMemberFunction = true;
+	SigCharLineIndex.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigCharLineIndex.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterIndex")));
+	SigCharLineIndex.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("LineIndex")));
+	OutFunctions.Add(SigCharLineIndex);
+
+	// Register GetCharacterWordIndex
+	FNiagaraFunctionSignature SigCharWordIndex;
+	SigCharWordIndex.Name = GetCharacterWordIndexName;
+#if WITH_EDITORONLY_DATA
+	SigCharWordIndex.Description = LOCTEXT("GetCharacterWordIndexDesc", "Returns the index of the word the character at CharacterIndex belongs to. Whitespace belongs to the word before it; whitespace before the first word returns -1.");
+#endif
+	SigCharWordIndex.bMemberFunction = true;
+	SigCharWordIndex.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigCharWordIndex.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterIndex")));
+	SigCharWordIndex.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("WordIndex")));
+	OutFunctions.Add(SigCharWordIndex);
+
+	// Register GetCharacterIndexInLine
+	FNiagaraFunctionSignature SigCharIndexInLine;
+	SigCharIndexInLine.Name = GetCharacterIndexInLineName;
+#if WITH_EDITORONLY_DATA
+	SigCharIndexInLine.Description = LOCTEXT("GetCharacterIndexInLineDesc", "Returns the position of the character at CharacterIndex within its line (0 for the first character of the line).");
+#endif
+	SigCharIndexInLine.bMemberFunction = true;
+	SigCharIndexInLine.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigCharIndexInLine.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterIndex")));
+	SigCharIndexInLine.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("IndexInLine")));
+	OutFunctions.Add(SigCharIndexInLine);
+
+	// Register GetCharacterIndexInWord
+	FNiagaraFunctionSignature SigCharIndexInWord;
+	SigCharIndexInWord.Name = GetCharacterIndexInWordName;
+#if WITH_EDITORONLY_DATA
+	SigCharIndexInWord.Description = LOCTEXT("GetCharacterIndexInWordDesc", "Returns the position of the character at CharacterIndex within its word (0 for the first character of the word). Trailing whitespace continues counting past the end of the word.");
+#endif
+	SigCharIndexInWord.bMemberFunction = true;
+	SigCharIndexInWord.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigCharIndexInWord.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterIndex")));
+	SigCharIndexInWord.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("IndexInWord")));
+	OutFunctions.Add(SigCharIndexInWord);
+
+	// Register GetCharacterNormalizedIndex
+	FNiagaraFunctionSignature SigCharNormalizedIndex;
+	SigCharNormalizedIndex.Name = GetCharacterNormalizedIndexName;
+#if WITH_EDITORONLY_DATA
+	SigCharNormalizedIndex.Description = LOCTEXT("GetCharacterNormalizedIndexDesc", "Returns the position of the character at CharacterIndex within its line, its word and the whole text, normalized to 0-1 (0 for the first character, 1 for the last).");
+#endif
+	SigCharNormalizedIndex.bMemberFunction = true;
+	SigCharNormalizedIndex.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigCharNormalizedIndex.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterIndex")));
+	SigCharNormalizedIndex.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("InLine")));
+	SigCharNormalizedIndex.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("InWord")));
+	SigCharNormalizedIndex.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("InText")));
+	OutFunctions.Add(SigCharNormalizedIndex);
+
+	// Register GetTextEntryCount
+	FNiagaraFunctionSignature SigEntryCount;
+	SigEntryCount.Name = GetTextEntryCountName;
+#if WITH_EDITORONLY_DATA
+	SigEntryCount.Description = LOCTEXT("GetTextEntryCountDesc", "Returns the number of text entries in multi-text mode, 0 otherwise.");
+#endif
+	SigEntryCount.bMemberFunction = true;
+	SigEntryCount.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigEntryCount.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("EntryCount")));
+	OutFunctions.Add(SigEntryCount);
+
+	// Register GetCharacterEntry
+	FNiagaraFunctionSignature SigCharEntry;
+	SigCharEntry.Name = GetCharacterEntryName;
+#if WITH_EDITORONLY_DATA
+	SigCharEntry.Description = LOCTEXT("GetCharacterEntryDesc", "Returns the text entry the character at CharacterIndex belongs to and its index within that entry. Outside of multi-text mode the whole text is entry 0.");
+#endif
+	SigCharEntry.bMemberFunction = true;
+	SigCharEntry.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigCharEntry.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterIndex")));
+	SigCharEntry.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("EntryIndex")));
+	SigCharEntry.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("IndexInEntry")));
+	OutFunctions.Add(SigCharEntry);
+
+	// Register GetTextEntryInfo
+	FNiagaraFunctionSignature SigEntryInfo;
+	SigEntryInfo.Name = GetTextEntryInfoName;
+#if WITH_EDITORONLY_DATA
+	SigEntryInfo.Description = LOCTEXT("GetTextEntryInfoDesc", "Returns the origin, age and lifetime (0 if it lives until removed) of a text entry, and the range of characters it covers.");
+#endif
+	SigEntryInfo.bMemberFunction = true;
+	SigEntryInfo.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigEntryInfo.AddInput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("EntryIndex")));
+	SigEntryInfo.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetPositionDef(), TEXT("Origin")));
+	SigEntryInfo.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("Age")));
+	SigEntryInfo.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("Lifetime")));
+	SigEntryInfo.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("FirstCharacter")));
+	SigEntryInfo.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("CharacterCount")));
+	OutFunctions.Add(SigEntryInfo);
+
+	// Register GetLayoutReady
+	FNiagaraFunctionSignature SigLayoutReady;
+	SigLayoutReady.Name = GetLayoutReadyName;
+#if WITH_EDITORONLY_DATA
+	SigLayoutReady.Description = LOCTEXT("GetLayoutReadyDesc", "Returns 1 once the layout of the current text is available, 0 while a long text is still being laid out in the background. Character counts are 0 until the first layout is ready.");
+#endif
+	SigLayoutReady.bMemberFunction = true;
+	SigLayoutReady.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigLayoutReady.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetBoolDef(), TEXT("LayoutReady")));
+	OutFunctions.Add(SigLayoutReady);
+
+	// Register GetWindowFirstLine
+	FNiagaraFunctionSignature SigWindowFirstLine;
+	SigWindowFirstLine.Name = GetWindowFirstLineName;
+#if WITH_EDITORONLY_DATA
+	SigWindowFirstLine.Description = LOCTEXT("GetWindowFirstLineDesc", "In streaming mode, returns the line of the whole text that line 0 of the window is. Returns 0 outside of streaming mode.");
+#endif
+	SigWindowFirstLine.bMemberFunction = true;
+	SigWindowFirstLine.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigWindowFirstLine.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("WindowFirstLine")));
+	OutFunctions.Add(SigWindowFirstLine);
+
+	// Register GetDocumentLineCount
+	FNiagaraFunctionSignature SigDocumentLineCount;
+	SigDocumentLineCount.Name = GetDocumentLineCountName;
+#if WITH_EDITORONLY_DATA
+	SigDocumentLineCount.Description = LOCTEXT("GetDocumentLineCountDesc", "Returns the number of lines in the whole text, including the lines outside of the streaming window.");
+#endif
+	SigDocumentLineCount.bMemberFunction = true;
+	SigDocumentLineCount.AddInput(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Font UV Information interface")));
+	SigDocumentLineCount.AddOutput(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("DocumentLineCount")));
+	OutFunctions.Add(SigDocumentLineCount);
 }
 
 void UNTTDataInterface::BuildShaderParameters(FNiagaraShaderParametersBuilder& ShaderParametersBuilder) const
@@ -782,51 +1309,99 @@ void UNTTDataInterface::BuildShaderParameters(FNiagaraShaderParametersBuilder& S
 void UNTTDataInterface::SetShaderParameters(const FNiagaraDataInterfaceSetShaderParametersContext& Context) const
 {
 	FNDIFontUVInfoProxy& DataInterfaceProxy = Context.GetProxy<FNDIFontUVInfoProxy>();
-	FNDIFontUVInfoProxy::FRTInstanceData* RTData = DataInterfaceProxy.SystemInstancesToInstanceData_RT.Find(Context.GetSystemInstanceID());
-
-	FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
-	DataInterfaceProxy.EnsureDefaultBuffer(RHICmdList);
+	FNDIFontUVInfoProxy::FRTInstanceData* RTData = DataInterfaceProxy.FindInstance_RT(Context.GetSystemInstanceID());
 
 	FShaderParameters* ShaderParameters = Context.GetParameterNestedStruct<FShaderParameters>();
-	if (RTData && RTData->PackedBuffer.SRV.IsValid())
+	if (RTData && RTData->TextBuffer.IsValid())
 	{
-		ShaderParameters->PackedBuffer = RTData->PackedBuffer.SRV;
+		ShaderParameters->TextBuffer = RTData->TextBuffer->SRV;
+		ShaderParameters->CharRecordBuffer = RTData->bHasCharRecords ? RTData->CharRecordBuffer->SRV : GNTTDefaultBuffers.RecordBuffer.SRV;
+		ShaderParameters->EntryBuffer = RTData->EntryBuffer.IsValid() ? RTData->EntryBuffer->SRV : GNTTDefaultBuffers.FloatBuffer.SRV;
+		ShaderParameters->bHasCharRecords = RTData->bHasCharRecords ? 1u : 0u;
 		
-		ShaderParameters->Offset_UVs = RTData->Offset_UVs;
-		ShaderParameters->Offset_Sizes = RTData->Offset_Sizes;
-		ShaderParameters->Offset_Unicode = RTData->Offset_Unicode;
+		ShaderParameters->Offset_GlyphIndices = RTData->Offset_GlyphIndices;
 		ShaderParameters->Offset_Positions = RTData->Offset_Positions;
+		ShaderParameters->Offset_CharLine = RTData->Offset_CharLine;
+		ShaderParameters->Offset_CharWord = RTData->Offset_CharWord;
 		ShaderParameters->Offset_LineStart = RTData->Offset_LineStart;
 		ShaderParameters->Offset_LineCount = RTData->Offset_LineCount;
 		ShaderParameters->Offset_WordStart = RTData->Offset_WordStart;
 		ShaderParameters->Offset_WordCount = RTData->Offset_WordCount;
+		ShaderParameters->Offset_WordPrefix = RTData->Offset_WordPrefix;
+		ShaderParameters->Offset_WordTrailingPrefix = RTData->Offset_WordTrailingPrefix;
+		ShaderParameters->Offset_LinePrefix = RTData->Offset_LinePrefix;
+		ShaderParameters->Offset_CharEntry = RTData->Offset_CharEntry;
+		ShaderParameters->Offset_EntryStart = RTData->Offset_EntryStart;
+		ShaderParameters->Offset_EntryCount = RTData->Offset_EntryCount;
+		ShaderParameters->Offset_EntryOrigin = RTData->Offset_EntryOrigin;
+		ShaderParameters->Offset_EntryTime = RTData->Offset_EntryTime;
 
-		ShaderParameters->NumRects = RTData->NumRects;
 		ShaderParameters->NumChars = RTData->NumChars;
 		ShaderParameters->NumLines = RTData->NumLines;
 		ShaderParameters->NumWords = RTData->NumWords;
+		ShaderParameters->NumEntries = RTData->NumEntries;
 		ShaderParameters->bFilterWhitespaceCharactersValue = RTData->bFilterWhitespaceCharactersValue;
 		ShaderParameters->TotalTextHeight = RTData->TotalTextHeight;
+		ShaderParameters->TextVersion = RTData->LayoutVersion;
+		ShaderParameters->EntryClock = RTData->EntryClock;
+		ShaderParameters->TextEncoding = RTData->TextEncoding;
+		ShaderParameters->bLayoutReady = RTData->bLayoutReady;
+		ShaderParameters->WindowFirstLine = RTData->WindowFirstLine;
+		ShaderParameters->DocumentLineCount = RTData->DocumentLineCount;
 	}
 	else
 	{
-		ShaderParameters->PackedBuffer = DataInterfaceProxy.PackedBuffer.SRV;
+		ShaderParameters->TextBuffer = GNTTDefaultBuffers.FloatBuffer.SRV;
+		ShaderParameters->CharRecordBuffer = GNTTDefaultBuffers.RecordBuffer.SRV;
+		ShaderParameters->EntryBuffer = GNTTDefaultBuffers.FloatBuffer.SRV;
+		ShaderParameters->bHasCharRecords = 0;
 		
-		ShaderParameters->Offset_UVs = 0;
-		ShaderParameters->Offset_Sizes = 0;
-		ShaderParameters->Offset_Unicode = 0;
+		ShaderParameters->Offset_GlyphIndices = 0;
 		ShaderParameters->Offset_Positions = 0;
+		ShaderParameters->Offset_CharLine = 0;
+		ShaderParameters->Offset_CharWord = 0;
 		ShaderParameters->Offset_LineStart = 0;
 		ShaderParameters->Offset_LineCount = 0;
 		ShaderParameters->Offset_WordStart = 0;
 		ShaderParameters->Offset_WordCount = 0;
+		ShaderParameters->Offset_WordPrefix = 0;
+		ShaderParameters->Offset_WordTrailingPrefix = 0;
+		ShaderParameters->Offset_LinePrefix = 0;
+		ShaderParameters->Offset_CharEntry = 0;
+		ShaderParameters->Offset_EntryStart = 0;
+		ShaderParameters->Offset_EntryCount = 0;
+		ShaderParameters->Offset_EntryOrigin = 0;
+		ShaderParameters->Offset_EntryTime = 0;
 
-		ShaderParameters->NumRects = 0;
 		ShaderParameters->NumChars = 0;
 		ShaderParameters->NumLines = 0;
 		ShaderParameters->NumWords = 0;
+		ShaderParameters->NumEntries = 0;
 		ShaderParameters->bFilterWhitespaceCharactersValue = bFilterWhitespaceCharacters ? 1u : 0u;
 		ShaderParameters->TotalTextHeight = 0.0f;
+		ShaderParameters->TextVersion = 0;
+		ShaderParameters->EntryClock = 0.0f;
+		ShaderParameters->TextEncoding = 0;
+		ShaderParameters->bLayoutReady = 0;
+		ShaderParameters->WindowFirstLine = 0;
+		ShaderParameters->DocumentLineCount = 0;
+	}
+
+	if (RTData && RTData->GlyphBuffer.IsValid() && RTData->GlyphBuffer->Buffer.SRV.IsValid())
+	{
+		ShaderParameters->GlyphBuffer = RTData->GlyphBuffer->Buffer.SRV;
+		ShaderParameters->Offset_UVs = RTData->GlyphBuffer->Offset_UVs;
+		ShaderParameters->Offset_Sizes = RTData->GlyphBuffer->Offset_Sizes;
+		ShaderParameters->NumRects = RTData->GlyphBuffer->NumRects;
+		ShaderParameters->GlyphEncoding = RTData->GlyphBuffer->bCompact ? 1u : 0u;
+	}
+	else
+	{
+		ShaderParameters->GlyphBuffer = GNTTDefaultBuffers.FloatBuffer.SRV;
+		ShaderParameters->Offset_UVs = 0;
+		ShaderParameters->Offset_Sizes = 0;
+		ShaderParameters->NumRects = 0;
+		ShaderParameters->GlyphEncoding = 0;
 	}
 }
 
@@ -843,6 +1418,24 @@ bool UNTTDataInterface::CopyToInternal(UNiagaraDataInterface* Destination) const
 		DestTyped->KerningOffset = KerningOffset;
 		DestTyped->WhitespaceWidthMultiplier = WhitespaceWidthMultiplier;
 		DestTyped->bFilterWhitespaceCharacters = bFilterWhitespaceCharacters;
+		DestTyped->bNumericMode = bNumericMode;
+		DestTyped->NumericValue = NumericValue;
+		DestTyped->NumericFormat = NumericFormat;
+		DestTyped->bMultiTextMode = bMultiTextMode;
+		DestTyped->bStreamingMode = bStreamingMode;
+		DestTyped->StreamingWindowLines = StreamingWindowLines;
+		DestTyped->StreamingScrollLine = StreamingScrollLine;
+		DestTyped->bCountsInMinimalMode = bCountsInMinimalMode;
+		{
+			FScopeLock Lock(&ParameterLock);
+			FScopeLock DestLock(&DestTyped->ParameterLock);
+			DestTyped->TextEntries = TextEntries;
+			DestTyped->NextTextEntrySerial = NextTextEntrySerial;
+			DestTyped->TextEntryClockBase = TextEntryClockBase;
+			DestTyped->TextEntryLayoutsKey = TextEntryLayoutsKey;
+			DestTyped->NextTextEntryExpiry.store(NextTextEntryExpiry.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		DestTyped->MarkLayoutDirty();
 		return true;
 	}
 	else
@@ -852,6 +1445,37 @@ bool UNTTDataInterface::CopyToInternal(UNiagaraDataInterface* Destination) const
 	}
 }
 
+bool UNTTDataInterface::AreTextEntriesEqual(const UNTTDataInterface& Other) const
+{
+	if (&Other == this)
+	{
+		return true;
+	}
+
+	FScopeLock Lock(&ParameterLock);
+	FScopeLock OtherLock(&Other.ParameterLock);
+	if (TextEntries.Num() != Other.TextEntries.Num() || TextEntryClockBase != Other.TextEntryClockBase)
+	{
+		return false;
+	}
+
+	// Entries keep their index for their whole life, so matching sets line up index by index
+	auto OtherIt = Other.TextEntries.CreateConstIterator();
+	for (auto It = TextEntries.CreateConstIterator(); It; ++It, ++OtherIt)
+	{
+		if (It.GetIndex() != OtherIt.GetIndex()
+			|| It->Serial != OtherIt->Serial
+			|| !It->Text.Equals(OtherIt->Text, ESearchCase::CaseSensitive)
+			|| It->Origin != OtherIt->Origin
+			|| It->AddTime != OtherIt->AddTime
+			|| It->Lifetime != OtherIt->Lifetime)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 bool UNTTDataInterface::Equals(const UNiagaraDataInterface* Other) const
 {
 	const UNTTDataInterface* OtherTyped = Cast<UNTTDataInterface>(Other);
@@ -863,7 +1487,16 @@ bool UNTTDataInterface::Equals(const UNiagaraDataInterface* Other) const
 		&& OtherTyped->VerticalOffset == VerticalOffset
 		&& OtherTyped->KerningOffset == KerningOffset
 		&& OtherTyped->WhitespaceWidthMultiplier == WhitespaceWidthMultiplier
-		&& OtherTyped->bFilterWhitespaceCharacters == bFilterWhitespaceCharacters;
+		&& OtherTyped->bFilterWhitespaceCharacters == bFilterWhitespaceCharacters
+		&& OtherTyped->bNumericMode == bNumericMode
+		&& OtherTyped->NumericValue == NumericValue
+		&& OtherTyped->NumericFormat == NumericFormat
+		&& OtherTyped->bMultiTextMode == bMultiTextMode
+		&& OtherTyped->bStreamingMode == bStreamingMode
+		&& OtherTyped->StreamingWindowLines == StreamingWindowLines
+		&& OtherTyped->StreamingScrollLine == StreamingScrollLine
+		&& OtherTyped->bCountsInMinimalMode == bCountsInMinimalMode
+		&& AreTextEntriesEqual(*OtherTyped);
 		UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI: Equals - ThisAsset=%s OtherAsset=%s Result=%s"),
 		*GetNameSafe(FontAsset),
 		OtherTyped ? *GetNameSafe(OtherTyped->FontAsset) : TEXT("nullptr"),
@@ -904,39 +1537,87 @@ void UNTTDataInterface::GetVMExternalFunction(const FVMExternalFunctionBindingIn
 		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetTextWordCountVM(Context); });
 		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
 	}
-	else if (BindingInfo.Name == GetWordCharacterCountName)
+	else if (BindingInfo.Name == GetWordCharacterCountName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetWordCharacterCountVM(Context); });
+		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+	}
+	else if (BindingInfo.Name == GetWordTrailingWhitespaceCountName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetWordTrailingWhitespaceCountVM(Context); });
+		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+	}
+	else if (BindingInfo.Name == GetFilterWhitespaceCharactersName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetFilterWhitespaceCharactersVM(Context); });
+		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+	}
+	else if (BindingInfo.Name == GetCharacterCountInWordRangeName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterCountInWordRangeVM(Context); });
+		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+	}
+	else if (BindingInfo.Name == GetCharacterCountInLineRangeName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterCountInLineRangeVM(Context); });
+		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+	}
+	else if (BindingInfo.Name == GetCharacterSpriteSizeName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterSpriteSizeVM(Context); });
+		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+	}
+	else if (BindingInfo.Name == GetTextHeightName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetTextHeightVM(Context); });
+	}
+	else if (BindingInfo.Name == GetTextVersionName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetTextVersionVM(Context); });
+	}
+	else if (BindingInfo.Name == GetCharacterLineIndexName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterLineIndexVM(Context); });
+	}
+	else if (BindingInfo.Name == GetCharacterWordIndexName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterWordIndexVM(Context); });
+	}
+	else if (BindingInfo.Name == GetCharacterIndexInLineName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterIndexInLineVM(Context); });
+	}
+	else if (BindingInfo.Name == GetCharacterIndexInWordName)
+	{
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterIndexInWordVM(Context); });
+	}
+	else if (BindingInfo.Name == GetCharacterNormalizedIndexName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetWordCharacterCountVM(Context); });
-		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterNormalizedIndexVM(Context); });
 	}
-	else if (BindingInfo.Name == GetWordTrailingWhitespaceCountName)
+	else if (BindingInfo.Name == GetTextEntryCountName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetWordTrailingWhitespaceCountVM(Context); });
-		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetTextEntryCountVM(Context); });
 	}
-	else if (BindingInfo.Name == GetFilterWhitespaceCharactersName)
+	else if (BindingInfo.Name == GetCharacterEntryName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetFilterWhitespaceCharactersVM(Context); });
-		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterEntryVM(Context); });
 	}
-	else if (BindingInfo.Name == GetCharacterCountInWordRangeName)
+	else if (BindingInfo.Name == GetTextEntryInfoName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterCountInWordRangeVM(Context); });
-		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetTextEntryInfoVM(Context); });
 	}
-	else if (BindingInfo.Name == GetCharacterCountInLineRangeName)
+	else if (BindingInfo.Name == GetLayoutReadyName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterCountInLineRangeVM(Context); });
-		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetLayoutReadyVM(Context); });
 	}
-	else if (BindingInfo.Name == GetCharacterSpriteSizeName)
+	else if (BindingInfo.Name == GetWindowFirstLineName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetCharacterSpriteSizeVM(Context); });
-		//UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI: GetVMExternalFunction - Bound function '%s'"), *BindingInfo.Name.ToString());
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetWindowFirstLineVM(Context); });
 	}
-	else if (BindingInfo.Name == GetTextHeightName)
+	else if (BindingInfo.Name == GetDocumentLineCountName)
 	{
-		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetTextHeightVM(Context); });
+		OutFunc = FVMExternalFunction::CreateLambda([this](FVectorVMExternalFunctionContext& Context) { this->GetDocumentLineCountVM(Context); });
 	}
 	else
 	{
@@ -945,95 +1626,93 @@ void UNTTDataInterface::GetVMExternalFunction(const FVMExternalFunctionBindingIn
 }
 
 
-// Implementation called by the vectorVM
-void UNTTDataInterface::GetCharacterUVVM(FVectorVMExternalFunctionContext& Context)
+// Helpers shared by the VM implementations below.
+// Outputs the script doesn't read have no register, so every bulk write goes through a null-checked destination.
+namespace NTTVMKernels
 {
-	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
-	FNDIInputParam<int32> InCharacterIndex(Context);
-	FNDIOutputParam<float> OutUSize(Context);
-	FNDIOutputParam<float> OutVSize(Context);
-	FNDIOutputParam<float> OutUStart(Context);
-	FNDIOutputParam<float> OutVStart(Context);
-
-	const TArray<int32>& Unicode = InstData.Get()->Unicode;
-	const TArray<FVector4>& TextureUvs = InstData.Get()->CharacterTextureUvs;
-	const int32 NumRects = TextureUvs.Num();
-	const int32 NumChars = Unicode.Num();
+	template<typename T>
+	FORCEINLINE T* GetDest(VectorVM::FExternalFuncRegisterHandler<T>& Register)
+	{
+		return Register.IsValid() ? Register.GetDest() : nullptr;
+	}
 
-	// Iterate over the particles
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+	// Runs a per-index query once and splats it when the input is uniform, otherwise once per instance.
+	template<typename FuncType>
+	void RunIntQuery(FVectorVMExternalFunctionContext& Context, FNDIInputParam<int32>& InIndex, FNDIOutputParam<int32>& Out, FuncType Func)
 	{
-		int32 CharacterIndex = InCharacterIndex.GetAndAdvance();
+		const int32 NumInstances = Context.GetNumInstances();
+		int32* RESTRICT Dest = GetDest(Out.Data);
 
-		if (NumChars > 0)
+		if (InIndex.IsConstant())
 		{
-			CharacterIndex = CharacterIndex % NumChars;
+			SplatInt(Dest, NumInstances, Func(InIndex.GetAndAdvance()));
+			return;
 		}
 
-		const int32 UnicodeIndex = (Unicode.IsValidIndex(CharacterIndex)) ? Unicode[CharacterIndex] : -1;
-
-		// Bounds check
-		if (NumRects > 0 && UnicodeIndex >= 0 && UnicodeIndex < NumRects)
+		for (int32 i = 0; i < NumInstances; ++i)
 		{
-			const FVector4& UVRect = TextureUvs[UnicodeIndex];
-			OutUSize.SetAndAdvance(UVRect.X);
-			OutVSize.SetAndAdvance(UVRect.Y);
-			OutUStart.SetAndAdvance(UVRect.Z);
-			OutVStart.SetAndAdvance(UVRect.W);
-
-			if (i < 4)
+			const int32 Result = Func(InIndex.GetAndAdvance());
+			if (Dest != nullptr)
 			{
-				UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI: VM idx=%d UnicodeIndex=%d -> CharacterTextureUV=[%s]"),
-					i, UnicodeIndex, *UVRect.ToString());
+				Dest[i] = Result;
 			}
 		}
-		else
+	}
+
+	// Same as RunIntQuery for queries over an index range
+	template<typename FuncType>
+	void RunIntRangeQuery(FVectorVMExternalFunctionContext& Context, FNDIInputParam<int32>& InStart, FNDIInputParam<int32>& InEnd, FNDIOutputParam<int32>& Out, FuncType Func)
+	{
+		const int32 NumInstances = Context.GetNumInstances();
+		int32* RESTRICT Dest = GetDest(Out.Data);
+
+		if (InStart.IsConstant() && InEnd.IsConstant())
 		{
-			// Return zero for invalid indices
-			OutUSize.SetAndAdvance(0.0f);
-			OutVSize.SetAndAdvance(0.0f);
-			OutUStart.SetAndAdvance(0.0f);
-			OutVStart.SetAndAdvance(0.0f);
+			const int32 Start = InStart.GetAndAdvance();
+			SplatInt(Dest, NumInstances, Func(Start, InEnd.GetAndAdvance()));
+			return;
+		}
 
-			if (i < 4)
+		for (int32 i = 0; i < NumInstances; ++i)
+		{
+			const int32 Start = InStart.GetAndAdvance();
+			const int32 Result = Func(Start, InEnd.GetAndAdvance());
+			if (Dest != nullptr)
 			{
-				UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT DI: VM idx=%d UnicodeIndex=%d out of bounds (NumRects=%d) - returning zeros"),
-					i, UnicodeIndex, NumRects);
+				Dest[i] = Result;
 			}
 		}
 	}
 }
 
-void UNTTDataInterface::GetCharacterPositionVM(FVectorVMExternalFunctionContext& Context)
+// Implementation called by the vectorVM
+void UNTTDataInterface::GetCharacterUVVM(FVectorVMExternalFunctionContext& Context)
 {
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIInputParam<int32> InCharacterIndex(Context);
-	FNDIOutputParam<FVector3f> OutPosition(Context);
+	FNDIOutputParam<float> OutUSize(Context);
+	FNDIOutputParam<float> OutVSize(Context);
+	FNDIOutputParam<float> OutUStart(Context);
+	FNDIOutputParam<float> OutVStart(Context);
 
-	const TArray<FVector2f>& Positions = InstData.Get()->CharacterPositions;
-	const int32 NumChars = InstData.Get()->Unicode.Num();
+	const FNTTGlyphTable& GlyphTable = *InstData.Get()->GlyphTable;
+	const FNTTGlyphChannels& Channels = GlyphTable.Channels;
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
-	{
-		int32 Index = InCharacterIndex.GetAndAdvance();
+	// Characters without a valid glyph read the trailing zero glyph, so they return zeros.
+	const float* const Src[4] = { Channels.USize.GetData(), Channels.VSize.GetData(), Channels.UStart.GetData(), Channels.VStart.GetData() };
+	float* const Dest[4] = { NTTVMKernels::GetDest(OutUSize.Data), NTTVMKernels::GetDest(OutVSize.Data), NTTVMKernels::GetDest(OutUStart.Data), NTTVMKernels::GetDest(OutVStart.Data) };
 
-		if (NumChars <= 0)
-		{
-			OutPosition.SetAndAdvance(FVector3f(0.0f, 0.0f, 0.0f));
-			continue;
-		}
+	NTTVMKernels::GatherGlyphChannels(Context.GetNumInstances(), *InstData.Get()->Layout, GlyphTable, InCharacterIndex, Src, Dest);
+}
 
-		Index = Index % NumChars;
-		const FVector2f Position2 = Positions.IsValidIndex(Index) ? Positions[Index] : FVector2f(0.0f, 0.0f);
+void UNTTDataInterface::GetCharacterPositionVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<FVector3f> OutPosition(Context);
 
-		// UE Coordinates: X (forward) = 0, Y (left/right) = horizontal, Z (up/down) = vertical
-		// The position is calculated by adding the cumulative character widths and line heights (positive values)
-		// This causes the vertical component to go in the positive direction, but the final Z value should be negative
-		// for subsequent lines. Similarly the horizontal component goes in the positive direction, but positive Y
-		// in UE's cooridnate system is left, and we need the text to go right.
-		// So, we flip both values
-		OutPosition.SetAndAdvance(FVector3f(0.0f, -Position2.X, -Position2.Y));
-	}
+	NTTVMKernels::GatherCharacterPositions(Context.GetNumInstances(), *InstData.Get()->Layout, InCharacterIndex,
+		NTTVMKernels::GetDest(OutPosition.X), NTTVMKernels::GetDest(OutPosition.Y), NTTVMKernels::GetDest(OutPosition.Z));
 }
 
 void UNTTDataInterface::GetTextCharacterCountVM(FVectorVMExternalFunctionContext& Context)
@@ -1041,12 +1720,7 @@ void UNTTDataInterface::GetTextCharacterCountVM(FVectorVMExternalFunctionContext
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIOutputParam<int32> OutLen(Context);
 
-	const int32 NumChars = InstData.Get()->Unicode.Num();
-
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
-	{
-		OutLen.SetAndAdvance(NumChars);
-	}
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutLen.Data), Context.GetNumInstances(), InstData.Get()->Layout->GetCharacterCount());
 }
 
 void UNTTDataInterface::GetTextLineCountVM(FVectorVMExternalFunctionContext& Context)
@@ -1054,15 +1728,10 @@ void UNTTDataInterface::GetTextLineCountVM(FVectorVMExternalFunctionContext& Con
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIOutputParam<int32> OutTotalLines(Context);
 
-	const int32 NumLines = InstData.Get()->LineStartIndices.Num();
-
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
-	{
-		OutTotalLines.SetAndAdvance(NumLines);
-	}
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutTotalLines.Data), Context.GetNumInstances(), InstData.Get()->Layout->NumLines());
 }
 
-static int32 GetLineCharacterCountInternal(const FNDIFontUVInfoInstanceData* Data, int32 LineIndex)
+static int32 GetLineCharacterCountInternal(const FNTTTextLayout* Data, int32 LineIndex)
 {
 	const TArray<int32>& LineCharacterCounts = Data->LineCharacterCounts;
 	const int32 NumLines = Data->LineStartIndices.Num();
@@ -1081,14 +1750,11 @@ void UNTTDataInterface::GetLineCharacterCountVM(FVectorVMExternalFunctionContext
 	FNDIInputParam<int32> InLineIndex(Context);
 	FNDIOutputParam<int32> OutLineCharacterCount(Context);
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InLineIndex, OutLineCharacterCount, [Data](int32 LineIndex)
 	{
-		int32 LineIndex = InLineIndex.GetAndAdvance();
-
-		const FNDIFontUVInfoInstanceData* Data = InstData.Get();
-		const int32 CharCount = GetLineCharacterCountInternal(Data, LineIndex);
-		OutLineCharacterCount.SetAndAdvance(CharCount);
-	}
+		return GetLineCharacterCountInternal(Data, LineIndex);
+	});
 }
 
 void UNTTDataInterface::GetTextWordCountVM(FVectorVMExternalFunctionContext& Context)
@@ -1096,15 +1762,10 @@ void UNTTDataInterface::GetTextWordCountVM(FVectorVMExternalFunctionContext& Con
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIOutputParam<int32> OutWordCount(Context);
 
-	const int32 NumWords = InstData.Get()->WordStartIndices.Num();
-
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
-	{
-		OutWordCount.SetAndAdvance(NumWords);
-	}
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutWordCount.Data), Context.GetNumInstances(), InstData.Get()->Layout->NumWords());
 }
 
-static int32 GetWordCharacterCountInternal(const FNDIFontUVInfoInstanceData* Data, int32 WordIndex)
+static int32 GetWordCharacterCountInternal(const FNTTTextLayout* Data, int32 WordIndex)
 {
 	const TArray<int32>& WordCharacterCounts = Data->WordCharacterCounts;
 	const int32 NumWords = Data->WordStartIndices.Num();
@@ -1117,12 +1778,12 @@ static int32 GetWordCharacterCountInternal(const FNDIFontUVInfoInstanceData* Dat
 	return 0;
 }
 
-static int32 GetWordTrailingWhitespaceCountInternal(const FNDIFontUVInfoInstanceData* Data, int32 WordIndex)
+static int32 GetWordTrailingWhitespaceCountInternal(const FNTTTextLayout* Data, int32 WordIndex)
 {
 	const TArray<int32>& WordStartIndices = Data->WordStartIndices;
 	const TArray<int32>& WordCharacterCounts = Data->WordCharacterCounts;
 	const int32 NumWords = WordStartIndices.Num();
-	const int32 TotalChars = Data->Unicode.Num();
+	const int32 TotalChars = Data->GetCharacterCount();
 
 	if (NumWords > 0 && WordIndex >= 0 && WordIndex < NumWords &&
 		WordCharacterCounts.IsValidIndex(WordIndex) && WordStartIndices.IsValidIndex(WordIndex))
@@ -1141,20 +1802,35 @@ static int32 GetWordTrailingWhitespaceCountInternal(const FNDIFontUVInfoInstance
 	return 0;
 }
 
+// Sums entries [Start, End] of a table through its prefix sums (Num + 1 entries, leading zero).
+// Start wraps around Num and End keeps its distance from Start before being clamped into the table;
+// a negative wrapped Start counts from the first entry and an empty range returns 0.
+static int32 GetCountInRangeInternal(const TArray<int32>& Prefix, int32 Num, int32 StartIndex, int32 EndIndex)
+{
+	if (Num <= 0 || Prefix.Num() != Num + 1)
+	{
+		return 0;
+	}
+
+	const int32 Delta = EndIndex - StartIndex;
+	const int32 WrappedStart = StartIndex % Num;
+	const int32 First = FMath::Max(WrappedStart, 0);
+	const int32 Last = FMath::Clamp(WrappedStart + Delta, 0, Num - 1);
+
+	return (First <= Last) ? Prefix[Last + 1] - Prefix[First] : 0;
+}
+
 void UNTTDataInterface::GetWordCharacterCountVM(FVectorVMExternalFunctionContext& Context)
 {
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIInputParam<int32> InWordIndex(Context);
 	FNDIOutputParam<int32> OutWordCharacterCount(Context);
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InWordIndex, OutWordCharacterCount, [Data](int32 WordIndex)
 	{
-		int32 WordIndex = InWordIndex.GetAndAdvance();
-
-		const FNDIFontUVInfoInstanceData* Data = InstData.Get();
-		const int32 CharCount = GetWordCharacterCountInternal(Data, WordIndex);
-		OutWordCharacterCount.SetAndAdvance(CharCount);
-	}
+		return GetWordCharacterCountInternal(Data, WordIndex);
+	});
 }
 
 void UNTTDataInterface::GetWordTrailingWhitespaceCountVM(FVectorVMExternalFunctionContext& Context)
@@ -1163,13 +1839,11 @@ void UNTTDataInterface::GetWordTrailingWhitespaceCountVM(FVectorVMExternalFuncti
 	FNDIInputParam<int32> InWordIndex(Context);
 	FNDIOutputParam<int32> OutTrailingWhitespaceCount(Context);
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InWordIndex, OutTrailingWhitespaceCount, [Data](int32 WordIndex)
 	{
-		int32 WordIndex = InWordIndex.GetAndAdvance();
-		const FNDIFontUVInfoInstanceData* Data = InstData.Get();
-		const int32 TrailingSpace = GetWordTrailingWhitespaceCountInternal(Data, WordIndex);
-		OutTrailingWhitespaceCount.SetAndAdvance(TrailingSpace);
-	}
+		return GetWordTrailingWhitespaceCountInternal(Data, WordIndex);
+	});
 }
 
 void UNTTDataInterface::GetFilterWhitespaceCharactersVM(FVectorVMExternalFunctionContext& Context)
@@ -1177,7 +1851,7 @@ void UNTTDataInterface::GetFilterWhitespaceCharactersVM(FVectorVMExternalFunctio
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIOutputParam<bool> OutFilter(Context);
 
-	const bool bValue = InstData.Get()->bFilterWhitespaceCharactersValue;
+	const bool bValue = InstData.Get()->Layout->bFilterWhitespaceCharactersValue;
 
 	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
 	{
@@ -1192,134 +1866,400 @@ void UNTTDataInterface::GetCharacterCountInWordRangeVM(FVectorVMExternalFunction
 	FNDIInputParam<int32> InEndWordIndex(Context);
 	FNDIOutputParam<int32> OutCharacterCountInRange(Context);
 
-	const TArray<int32>& WordStartIndices = InstData.Get()->WordStartIndices;
-	const TArray<int32>& WordCharacterCounts = InstData.Get()->WordCharacterCounts;
-	const int32 NumWords = WordStartIndices.Num();
-	const int32 TotalChars = InstData.Get()->Unicode.Num();
-	const bool bFilterWhitespace = InstData.Get()->bFilterWhitespaceCharactersValue;
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	const int32 NumWords = Data->WordStartIndices.Num();
+	const bool bFilterWhitespace = Data->bFilterWhitespaceCharactersValue;
+
+	// Trailing whitespace is only part of the range when it isn't filtered out
+	const TArray<int32>& Prefix = bFilterWhitespace ? Data->WordCharacterCountPrefix : Data->WordWithTrailingWhitespacePrefix;
+
+	NTTVMKernels::RunIntRangeQuery(Context, InStartWordIndex, InEndWordIndex, OutCharacterCountInRange, [&Prefix, NumWords](int32 StartWordIndex, int32 EndWordIndex)
+	{
+		return GetCountInRangeInternal(Prefix, NumWords, StartWordIndex, EndWordIndex);
+	});
+}
+
+void UNTTDataInterface::GetCharacterCountInLineRangeVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InStartLineIndex(Context);
+	FNDIInputParam<int32> InEndLineIndex(Context);
+	FNDIOutputParam<int32> OutCharacterCountInLineRange(Context);
+
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	const int32 NumLines = Data->LineStartIndices.Num();
+	const TArray<int32>& Prefix = Data->LineCharacterCountPrefix;
+
+	NTTVMKernels::RunIntRangeQuery(Context, InStartLineIndex, InEndLineIndex, OutCharacterCountInLineRange, [&Prefix, NumLines](int32 StartLineIndex, int32 EndLineIndex)
+	{
+		return GetCountInRangeInternal(Prefix, NumLines, StartLineIndex, EndLineIndex);
+	});
+}
+
+void UNTTDataInterface::GetCharacterSpriteSizeVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<FVector2f> OutSpriteSize(Context);
+
+	const FNTTGlyphTable& GlyphTable = *InstData.Get()->GlyphTable;
+	const FNTTGlyphChannels& Channels = GlyphTable.Channels;
+
+	const float* const Src[2] = { Channels.Width.GetData(), Channels.Height.GetData() };
+	float* const Dest[2] = { NTTVMKernels::GetDest(OutSpriteSize.X), NTTVMKernels::GetDest(OutSpriteSize.Y) };
+
+	NTTVMKernels::GatherGlyphChannels(Context.GetNumInstances(), *InstData.Get()->Layout, GlyphTable, InCharacterIndex, Src, Dest);
+}
+
+void UNTTDataInterface::GetTextHeightVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIOutputParam<float> OutTextHeight(Context);
+
+	NTTVMKernels::SplatFloat(NTTVMKernels::GetDest(OutTextHeight.Data), Context.GetNumInstances(), InstData.Get()->Layout->TotalTextHeight);
+}
+
+void UNTTDataInterface::GetTextVersionVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIOutputParam<int32> OutTextVersion(Context);
+
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutTextVersion.Data), Context.GetNumInstances(), (int32)InstData.Get()->LayoutVersion);
+}
+
+void UNTTDataInterface::GetLayoutReadyVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIOutputParam<bool> OutReady(Context);
+
+	const bool bReady = InstData.Get()->IsLayoutReady();
 
 	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
 	{
-		int32 StartWordIndex = InStartWordIndex.GetAndAdvance();
-		int32 EndWordIndex = InEndWordIndex.GetAndAdvance();
+		OutReady.SetAndAdvance(bReady);
+	}
+}
 
-		int32 TotalInRange = 0;
+void UNTTDataInterface::GetWindowFirstLineVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIOutputParam<int32> OutFirstLine(Context);
 
-		if (NumWords > 0)
-		{
-			const int32 Delta = EndWordIndex - StartWordIndex;
-			StartWordIndex = StartWordIndex % NumWords;
-			EndWordIndex = StartWordIndex + Delta;
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutFirstLine.Data), Context.GetNumInstances(), InstData.Get()->Layout->WindowFirstLine);
+}
 
-			const int32 StartIndex = StartWordIndex;
-			const int32 EndIndex   = FMath::Clamp(EndWordIndex, 0, NumWords - 1);
+void UNTTDataInterface::GetDocumentLineCountVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIOutputParam<int32> OutLineCount(Context);
 
-			if (StartIndex <= EndIndex)
-			{
-				for (int32 WordIndex = StartIndex; WordIndex <= EndIndex; ++WordIndex)
-				{
-					const FNDIFontUVInfoInstanceData* Data = InstData.Get();
-					const int32 CharCount = GetWordCharacterCountInternal(Data, WordIndex);
-					TotalInRange += CharCount;
-
-					if (!bFilterWhitespace)
-					{
-						const int32 TrailingSpace = GetWordTrailingWhitespaceCountInternal(Data, WordIndex);
-						TotalInRange += TrailingSpace;
-					}
-				}
-			}
-		}
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutLineCount.Data), Context.GetNumInstances(), InstData.Get()->Layout->GetDocumentLineCount());
+}
+
+// Per-character topology. Character indices wrap like every other per-character function.
+static int32 GetCharacterLineIndexInternal(const FNTTTextLayout* Data, int32 CharacterIndex)
+{
+	const int32 WrappedIndex = NTTVMKernels::WrapCharacterIndex(CharacterIndex, Data->NumCharacters());
+	return (WrappedIndex >= 0) ? Data->CharacterLineIndices[WrappedIndex] : INDEX_NONE;
+}
+
+static int32 GetCharacterWordIndexInternal(const FNTTTextLayout* Data, int32 CharacterIndex)
+{
+	const int32 WrappedIndex = NTTVMKernels::WrapCharacterIndex(CharacterIndex, Data->NumCharacters());
+	return (WrappedIndex >= 0) ? Data->CharacterWordIndices[WrappedIndex] : INDEX_NONE;
+}
 
-		OutCharacterCountInRange.SetAndAdvance(TotalInRange);
+static int32 GetCharacterIndexInLineInternal(const FNTTTextLayout* Data, int32 CharacterIndex)
+{
+	const int32 WrappedIndex = NTTVMKernels::WrapCharacterIndex(CharacterIndex, Data->NumCharacters());
+	return (WrappedIndex >= 0) ? Data->GetCharacterIndexInLine(WrappedIndex) : 0;
+}
+
+static int32 GetCharacterIndexInWordInternal(const FNTTTextLayout* Data, int32 CharacterIndex)
+{
+	const int32 WrappedIndex = NTTVMKernels::WrapCharacterIndex(CharacterIndex, Data->NumCharacters());
+	return (WrappedIndex >= 0) ? Data->GetCharacterIndexInWord(WrappedIndex) : 0;
+}
+
+// 0 for the first character of the line/word/text and 1 for the last; trailing whitespace clamps to 1 within its word.
+static FVector3f GetCharacterNormalizedIndexInternal(const FNTTTextLayout* Data, int32 CharacterIndex)
+{
+	const int32 NumChars = Data->NumCharacters();
+	const int32 WrappedIndex = NTTVMKernels::WrapCharacterIndex(CharacterIndex, NumChars);
+	if (WrappedIndex < 0)
+	{
+		return FVector3f(0.0f, 0.0f, 0.0f);
 	}
+
+	const int32 LineIndex = Data->CharacterLineIndices[WrappedIndex];
+	const int32 WordIndex = Data->CharacterWordIndices[WrappedIndex];
+	const int32 LineLength = Data->LineCharacterCounts[LineIndex];
+	const int32 WordLength = (WordIndex >= 0) ? Data->WordCharacterCounts[WordIndex] : 0;
+
+	const float InLine = (float)Data->GetCharacterIndexInLine(WrappedIndex) / (float)FMath::Max(LineLength - 1, 1);
+	const float InWord = (float)Data->GetCharacterIndexInWord(WrappedIndex) / (float)FMath::Max(WordLength - 1, 1);
+	const float InText = (float)WrappedIndex / (float)FMath::Max(NumChars - 1, 1);
+
+	return FVector3f(InLine, FMath::Min(InWord, 1.0f), InText);
 }
 
-void UNTTDataInterface::GetCharacterCountInLineRangeVM(FVectorVMExternalFunctionContext& Context)
+void UNTTDataInterface::GetCharacterLineIndexVM(FVectorVMExternalFunctionContext& Context)
 {
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
-	FNDIInputParam<int32> InStartLineIndex(Context);
-	FNDIInputParam<int32> InEndLineIndex(Context);
-	FNDIOutputParam<int32> OutCharacterCountInLineRange(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<int32> OutLineIndex(Context);
 
-	const int32 NumLines = InstData.Get()->LineStartIndices.Num();
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InCharacterIndex, OutLineIndex, [Data](int32 CharacterIndex)
+	{
+		return GetCharacterLineIndexInternal(Data, CharacterIndex);
+	});
+}
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+void UNTTDataInterface::GetCharacterWordIndexVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<int32> OutWordIndex(Context);
+
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InCharacterIndex, OutWordIndex, [Data](int32 CharacterIndex)
 	{
-		int32 StartLineIndex = InStartLineIndex.GetAndAdvance();
-		int32 EndLineIndex = InEndLineIndex.GetAndAdvance();
+		return GetCharacterWordIndexInternal(Data, CharacterIndex);
+	});
+}
 
-		int32 TotalInRange = 0;
+void UNTTDataInterface::GetCharacterIndexInLineVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<int32> OutIndexInLine(Context);
 
-		if (NumLines > 0)
-		{
-			const int32 Delta = EndLineIndex - StartLineIndex;
-			StartLineIndex = StartLineIndex % NumLines;
-			EndLineIndex = StartLineIndex + Delta;
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InCharacterIndex, OutIndexInLine, [Data](int32 CharacterIndex)
+	{
+		return GetCharacterIndexInLineInternal(Data, CharacterIndex);
+	});
+}
 
-			const int32 StartIndex = StartLineIndex;
-			const int32 EndIndex   = FMath::Clamp(EndLineIndex, 0, NumLines - 1);
+void UNTTDataInterface::GetCharacterIndexInWordVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<int32> OutIndexInWord(Context);
 
-			if (StartIndex <= EndIndex)
-			{
-				const FNDIFontUVInfoInstanceData* Data = InstData.Get();
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	NTTVMKernels::RunIntQuery(Context, InCharacterIndex, OutIndexInWord, [Data](int32 CharacterIndex)
+	{
+		return GetCharacterIndexInWordInternal(Data, CharacterIndex);
+	});
+}
 
-				for (int32 LineIndex = StartIndex; LineIndex <= EndIndex; ++LineIndex)
-				{
-					const int32 CharCount = GetLineCharacterCountInternal(Data, LineIndex);
-					TotalInRange += CharCount;
-				}
-			}
+void UNTTDataInterface::GetCharacterNormalizedIndexVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIInputParam<int32> InCharacterIndex(Context);
+	FNDIOutputParam<float> OutInLine(Context);
+	FNDIOutputParam<float> OutInWord(Context);
+	FNDIOutputParam<float> OutInText(Context);
+
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	const int32 NumInstances = Context.GetNumInstances();
+
+	float* RESTRICT DestInLine = NTTVMKernels::GetDest(OutInLine.Data);
+	float* RESTRICT DestInWord = NTTVMKernels::GetDest(OutInWord.Data);
+	float* RESTRICT DestInText = NTTVMKernels::GetDest(OutInText.Data);
+
+	if (InCharacterIndex.IsConstant())
+	{
+		const FVector3f Normalized = GetCharacterNormalizedIndexInternal(Data, InCharacterIndex.GetAndAdvance());
+		NTTVMKernels::SplatFloat(DestInLine, NumInstances, Normalized.X);
+		NTTVMKernels::SplatFloat(DestInWord, NumInstances, Normalized.Y);
+		NTTVMKernels::SplatFloat(DestInText, NumInstances, Normalized.Z);
+		return;
+	}
+
+	for (int32 i = 0; i < NumInstances; ++i)
+	{
+		const FVector3f Normalized = GetCharacterNormalizedIndexInternal(Data, InCharacterIndex.GetAndAdvance());
+		if (DestInLine != nullptr)
+		{
+			DestInLine[i] = Normalized.X;
+		}
+		if (DestInWord != nullptr)
+		{
+			DestInWord[i] = Normalized.Y;
 		}
+		if (DestInText != nullptr)
+		{
+			DestInText[i] = Normalized.Z;
+		}
+	}
+}
 
-		OutCharacterCountInLineRange.SetAndAdvance(TotalInRange);
+void UNTTDataInterface::GetTextEntryCountVM(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
+	FNDIOutputParam<int32> OutEntryCount(Context);
+
+	NTTVMKernels::SplatInt(NTTVMKernels::GetDest(OutEntryCount.Data), Context.GetNumInstances(), InstData.Get()->Layout->NumEntries());
+}
+
+// (EntryIndex, IndexInEntry) of a character. Without entries the whole text is entry 0.
+static FIntPoint GetCharacterEntryInternal(const FNTTTextLayout* Data, int32 CharacterIndex)
+{
+	const int32 WrappedIndex = NTTVMKernels::WrapCharacterIndex(CharacterIndex, Data->NumCharacters());
+	if (WrappedIndex < 0)
+	{
+		return FIntPoint(INDEX_NONE, 0);
+	}
+	if (Data->NumEntries() == 0)
+	{
+		return FIntPoint(0, WrappedIndex);
 	}
+
+	const int32 EntryIndex = Data->CharacterEntryIndices[WrappedIndex];
+	return FIntPoint(EntryIndex, WrappedIndex - Data->EntryStartIndices[EntryIndex]);
 }
 
-void UNTTDataInterface::GetCharacterSpriteSizeVM(FVectorVMExternalFunctionContext& Context)
+void UNTTDataInterface::GetCharacterEntryVM(FVectorVMExternalFunctionContext& Context)
 {
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
 	FNDIInputParam<int32> InCharacterIndex(Context);
-	FNDIOutputParam<FVector2f> OutSpriteSize(Context);
+	FNDIOutputParam<int32> OutEntryIndex(Context);
+	FNDIOutputParam<int32> OutIndexInEntry(Context);
 
-	const TArray<int32>& Unicode = InstData.Get()->Unicode;
-	const TArray<FVector2f>& SpriteSizes = InstData.Get()->CharacterSpriteSizes;
-	const int32 NumSizes = SpriteSizes.Num();
-	const int32 NumChars = Unicode.Num();
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	const int32 NumInstances = Context.GetNumInstances();
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+	int32* RESTRICT DestEntry = NTTVMKernels::GetDest(OutEntryIndex.Data);
+	int32* RESTRICT DestIndexInEntry = NTTVMKernels::GetDest(OutIndexInEntry.Data);
+
+	if (InCharacterIndex.IsConstant())
 	{
-		int32 CharacterIndex = InCharacterIndex.GetAndAdvance();
+		const FIntPoint Result = GetCharacterEntryInternal(Data, InCharacterIndex.GetAndAdvance());
+		NTTVMKernels::SplatInt(DestEntry, NumInstances, Result.X);
+		NTTVMKernels::SplatInt(DestIndexInEntry, NumInstances, Result.Y);
+		return;
+	}
 
-		if (NumChars > 0)
+	for (int32 i = 0; i < NumInstances; ++i)
+	{
+		const FIntPoint Result = GetCharacterEntryInternal(Data, InCharacterIndex.GetAndAdvance());
+		if (DestEntry != nullptr)
 		{
-			CharacterIndex = CharacterIndex % NumChars;
+			DestEntry[i] = Result.X;
 		}
+		if (DestIndexInEntry != nullptr)
+		{
+			DestIndexInEntry[i] = Result.Y;
+		}
+	}
+}
 
-		const int32 UnicodeIndex = (Unicode.IsValidIndex(CharacterIndex)) ? Unicode[CharacterIndex] : -1;
+struct FNTTTextEntryInfo
+{
+	FVector3f Origin = FVector3f::ZeroVector;
+	float Age = 0.0f;
+	float Lifetime = 0.0f;
+	int32 FirstCharacter = 0;
+	int32 CharacterCount = 0;
+};
 
-		if (NumSizes > 0 && UnicodeIndex >= 0 && UnicodeIndex < NumSizes)
+// Entry indices don't wrap; anything out of range returns an empty entry. Without entries the whole text is entry 0.
+static FNTTTextEntryInfo GetTextEntryInfoInternal(const FNTTTextLayout* Data, const FNTTEntryPlacements* Placements, float EntryClock, int32 EntryIndex)
+{
+	FNTTTextEntryInfo Info;
+	if (Data->NumEntries() == 0)
+	{
+		if (EntryIndex == 0)
 		{
-			const FVector2f& Size = SpriteSizes[UnicodeIndex];
-			OutSpriteSize.SetAndAdvance(Size);
+			Info.CharacterCount = Data->GetCharacterCount();
 		}
-		else
+		return Info;
+	}
+
+	if (EntryIndex >= 0 && EntryIndex < Data->NumEntries())
+	{
+		if (Placements != nullptr && EntryIndex < Placements->Num())
 		{
-			OutSpriteSize.SetAndAdvance(FVector2f(0.0f, 0.0f));
+			Info.Origin = Placements->EntryOrigins[EntryIndex];
+			Info.Age = EntryClock - Placements->EntryTimes[EntryIndex].X;
+			Info.Lifetime = Placements->EntryTimes[EntryIndex].Y;
 		}
+		Info.FirstCharacter = Data->EntryStartIndices[EntryIndex];
+		Info.CharacterCount = Data->EntryCharacterCounts[EntryIndex];
 	}
+	return Info;
 }
 
-void UNTTDataInterface::GetTextHeightVM(FVectorVMExternalFunctionContext& Context)
+void UNTTDataInterface::GetTextEntryInfoVM(FVectorVMExternalFunctionContext& Context)
 {
 	VectorVM::FUserPtrHandler<FNDIFontUVInfoInstanceData> InstData(Context);
-	FNDIOutputParam<float> OutTextHeight(Context);
-
-	const float Height = InstData.Get()->TotalTextHeight;
+	FNDIInputParam<int32> InEntryIndex(Context);
+	FNDIOutputParam<FVector3f> OutOrigin(Context);
+	FNDIOutputParam<float> OutAge(Context);
+	FNDIOutputParam<float> OutLifetime(Context);
+	FNDIOutputParam<int32> OutFirstCharacter(Context);
+	FNDIOutputParam<int32> OutCharacterCount(Context);
+
+	const FNTTTextLayout* Data = InstData.Get()->Layout.Get();
+	const FNTTEntryPlacements* Placements = InstData.Get()->EntryPlacements.Get();
+	const float EntryClock = InstData.Get()->EntryClock;
+	const int32 NumInstances = Context.GetNumInstances();
+
+	float* RESTRICT DestX = NTTVMKernels::GetDest(OutOrigin.X);
+	float* RESTRICT DestY = NTTVMKernels::GetDest(OutOrigin.Y);
+	float* RESTRICT DestZ = NTTVMKernels::GetDest(OutOrigin.Z);
+	float* RESTRICT DestAge = NTTVMKernels::GetDest(OutAge.Data);
+	float* RESTRICT DestLifetime = NTTVMKernels::GetDest(OutLifetime.Data);
+	int32* RESTRICT DestFirst = NTTVMKernels::GetDest(OutFirstCharacter.Data);
+	int32* RESTRICT DestCount = NTTVMKernels::GetDest(OutCharacterCount.Data);
+
+	if (InEntryIndex.IsConstant())
+	{
+		const FNTTTextEntryInfo Info = GetTextEntryInfoInternal(Data, Placements, EntryClock, InEntryIndex.GetAndAdvance());
+		NTTVMKernels::SplatFloat(DestX, NumInstances, Info.Origin.X);
+		NTTVMKernels::SplatFloat(DestY, NumInstances, Info.Origin.Y);
+		NTTVMKernels::SplatFloat(DestZ, NumInstances, Info.Origin.Z);
+		NTTVMKernels::SplatFloat(DestAge, NumInstances, Info.Age);
+		NTTVMKernels::SplatFloat(DestLifetime, NumInstances, Info.Lifetime);
+		NTTVMKernels::SplatInt(DestFirst, NumInstances, Info.FirstCharacter);
+		NTTVMKernels::SplatInt(DestCount, NumInstances, Info.CharacterCount);
+		return;
+	}
 
-	for (int32 i = 0; i < Context.GetNumInstances(); ++i)
+	for (int32 i = 0; i < NumInstances; ++i)
 	{
-		OutTextHeight.SetAndAdvance(Height);
+		const FNTTTextEntryInfo Info = GetTextEntryInfoInternal(Data, Placements, EntryClock, InEntryIndex.GetAndAdvance());
+		if (DestX != nullptr)
+		{
+			DestX[i] = Info.Origin.X;
+		}
+		if (DestY != nullptr)
+		{
+			DestY[i] = Info.Origin.Y;
+		}
+		if (DestZ != nullptr)
+		{
+			DestZ[i] = Info.Origin.Z;
+		}
+		if (DestAge != nullptr)
+		{
+			DestAge[i] = Info.Age;
+		}
+		if (DestLifetime != nullptr)
+		{
+			DestLifetime[i] = Info.Lifetime;
+		}
+		if (DestFirst != nullptr)
+		{
+			DestFirst[i] = Info.FirstCharacter;
+		}
+		if (DestCount != nullptr)
+		{
+			DestCount[i] = Info.CharacterCount;
+		}
 	}
 }
 
@@ -1350,7 +2290,19 @@ bool UNTTDataInterface::GetFunctionHLSL(const FNiagaraDataInterfaceGPUParamInfo&
 		|| FunctionInfo.DefinitionName == GetFilterWhitespaceCharactersName
 		|| FunctionInfo.DefinitionName == GetCharacterCountInWordRangeName
 		|| FunctionInfo.DefinitionName == GetCharacterCountInLineRangeName
-		|| FunctionInfo.DefinitionName == GetTextHeightName;
+		|| FunctionInfo.DefinitionName == GetTextHeightName
+		|| FunctionInfo.DefinitionName == GetTextVersionName
+		|| FunctionInfo.DefinitionName == GetCharacterLineIndexName
+		|| FunctionInfo.DefinitionName == GetCharacterWordIndexName
+		|| FunctionInfo.DefinitionName == GetCharacterIndexInLineName
+		|| FunctionInfo.DefinitionName == GetCharacterIndexInWordName
+		|| FunctionInfo.DefinitionName == GetCharacterNormalizedIndexName
+		|| FunctionInfo.DefinitionName == GetTextEntryCountName
+		|| FunctionInfo.DefinitionName == GetCharacterEntryName
+		|| FunctionInfo.DefinitionName == GetTextEntryInfoName
+		|| FunctionInfo.DefinitionName == GetLayoutReadyName
+		|| FunctionInfo.DefinitionName == GetWindowFirstLineName
+		|| FunctionInfo.DefinitionName == GetDocumentLineCountName;
 }
 
 void UNTTDataInterface::GetParameterDefinitionHLSL(const FNiagaraDataInterfaceGPUParamInfo& ParamInfo, FString& OutHLSL)
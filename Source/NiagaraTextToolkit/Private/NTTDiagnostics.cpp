@@ -0,0 +1,277 @@
+// Property of Lucian Tranc
+
+#include "NTTDiagnostics.h"
+#include "NTTDataInterface.h"
+#include "NTTLayoutCache.h"
+#include "NTTStats.h"
+#include "NiagaraSystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "RenderingThread.h"
+
+static const TCHAR* NTTMemReportCommand = TEXT("ntt.MemReport");
+
+static FAutoConsoleCommandWithOutputDevice CmdNTTDumpInstances(
+	TEXT("ntt.DumpInstances"),
+	TEXT("Lists live NTT instances with their system, font, character count and CPU/GPU bytes, largest first."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		FNTTInstanceRegistry::Get().DumpInstances(Ar);
+	}));
+
+static FAutoConsoleCommandWithOutputDevice CmdNTTMemReport(
+	TEXT("ntt.MemReport"),
+	TEXT("Writes NTT CPU and GPU memory per font and per Niagara system asset. Also part of memreport."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		FNTTInstanceRegistry::Get().MemReport(Ar);
+	}));
+
+namespace NTTDiagnosticsPrivate
+{
+	// Sums a set of instances, counting shared layouts, glyph tables and glyph buffers once
+	struct FMemoryGroup
+	{
+		int32 NumInstances = 0;
+		int64 NumCharacters = 0;
+		SIZE_T CPUBytes = 0;
+		SIZE_T GPUBytes = 0;
+		TSet<const void*> Layouts;
+		TSet<uint32> GlyphTables;
+
+		void Add(const FNTTInstanceSnapshot& Snapshot)
+		{
+			++NumInstances;
+			NumCharacters += Snapshot.NumCharacters;
+			// Instance block and its retired layouts, which are never shared
+			CPUBytes += Snapshot.CPUBytes - Snapshot.LayoutBytes;
+			GPUBytes += Snapshot.GPUBytes;
+
+			bool bAlreadyCounted = false;
+			if (Snapshot.Layout)
+			{
+				Layouts.Add(Snapshot.Layout, &bAlreadyCounted);
+				CPUBytes += bAlreadyCounted ? 0 : Snapshot.LayoutBytes;
+			}
+			if (Snapshot.GlyphTableId != 0)
+			{
+				GlyphTables.Add(Snapshot.GlyphTableId, &bAlreadyCounted);
+				CPUBytes += bAlreadyCounted ? 0 : Snapshot.GlyphTableBytes;
+				GPUBytes += bAlreadyCounted ? 0 : Snapshot.GlyphBufferBytes;
+			}
+		}
+	};
+
+	static double ToKB(SIZE_T Bytes)
+	{
+		return (double)Bytes / 1024.0;
+	}
+
+	static void LogGroups(FOutputDevice& Ar, const TCHAR* Title, TMap<FString, FMemoryGroup>& Groups)
+	{
+		Groups.ValueSort([](const FMemoryGroup& A, const FMemoryGroup& B)
+		{
+			return A.CPUBytes + A.GPUBytes > B.CPUBytes + B.GPUBytes;
+		});
+
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("%s:"), Title);
+		Ar.Logf(TEXT("%10s %12s %12s %12s  %s"), TEXT("Instances"), TEXT("Chars"), TEXT("CPU KB"), TEXT("GPU KB"), TEXT("Name"));
+		for (const TPair<FString, FMemoryGroup>& Pair : Groups)
+		{
+			const FMemoryGroup& Group = Pair.Value;
+			Ar.Logf(TEXT("%10d %12lld %12.1f %12.1f  %s"), Group.NumInstances, Group.NumCharacters, ToKB(Group.CPUBytes), ToKB(Group.GPUBytes), *Pair.Key);
+		}
+	}
+}
+
+FNTTInstanceRegistry& FNTTInstanceRegistry::Get()
+{
+	static FNTTInstanceRegistry Instance;
+	return Instance;
+}
+
+void FNTTInstanceRegistry::Initialize()
+{
+	// memreport runs every command listed under [MemReportCommands] in the engine config. The entry is only added in memory.
+	TArray<FString> Commands;
+	GConfig->GetArray(TEXT("MemReportCommands"), TEXT("Cmd"), Commands, GEngineIni);
+	if (!Commands.Contains(NTTMemReportCommand))
+	{
+		Commands.Add(NTTMemReportCommand);
+		GConfig->SetArray(TEXT("MemReportCommands"), TEXT("Cmd"), Commands, GEngineIni);
+	}
+}
+
+void FNTTInstanceRegistry::Shutdown()
+{
+	if (GConfig)
+	{
+		TArray<FString> Commands;
+		GConfig->GetArray(TEXT("MemReportCommands"), TEXT("Cmd"), Commands, GEngineIni);
+		if (Commands.Remove(NTTMemReportCommand) > 0)
+		{
+			GConfig->SetArray(TEXT("MemReportCommands"), TEXT("Cmd"), Commands, GEngineIni);
+		}
+	}
+}
+
+void FNTTInstanceRegistry::Register(const FNDIFontUVInfoInstanceData* InstanceData, FNDIFontUVInfoProxy* Proxy, FNiagaraSystemInstanceID InstanceID,
+	const UNTTDataInterface* DataInterface, const UNiagaraSystem* System)
+{
+	LLM_SCOPE_BYTAG(NTT);
+
+	FEntry Entry;
+	Entry.Proxy = Proxy;
+	Entry.InstanceID = InstanceID;
+	Entry.DataInterface = DataInterface;
+	Entry.System = System;
+
+	FScopeLock ScopeLock(&Lock);
+	Entries.Add(InstanceData, MoveTemp(Entry));
+}
+
+void FNTTInstanceRegistry::Unregister(const FNDIFontUVInfoInstanceData* InstanceData)
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Remove(InstanceData);
+}
+
+int32 FNTTInstanceRegistry::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Num();
+}
+
+TArray<FNTTInstanceSnapshot> FNTTInstanceRegistry::Gather() const
+{
+	check(IsInGameThread());
+
+	struct FGPUQuery
+	{
+		FNDIFontUVInfoProxy* Proxy = nullptr;
+		FNiagaraSystemInstanceID InstanceID = 0;
+		SIZE_T TextBytes = 0;
+		SIZE_T GlyphBytes = 0;
+	};
+
+	TArray<FNTTInstanceSnapshot> Snapshots;
+	TArray<FGPUQuery> Queries;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Snapshots.Reserve(Entries.Num());
+		Queries.Reserve(Entries.Num());
+
+		for (const TPair<const FNDIFontUVInfoInstanceData*, FEntry>& Pair : Entries)
+		{
+			const FNDIFontUVInfoInstanceData& InstanceData = *Pair.Key;
+			const FEntry& Entry = Pair.Value;
+			const UNTTDataInterface* DataInterface = Entry.DataInterface.Get();
+
+			FNTTInstanceSnapshot& Snapshot = Snapshots.AddDefaulted_GetRef();
+			Snapshot.InstanceID = Entry.InstanceID;
+			Snapshot.SystemName = GetPathNameSafe(Entry.System.Get());
+			Snapshot.FontName = GetNameSafe(DataInterface ? DataInterface->FontAsset : nullptr);
+
+			if (InstanceData.Layout.IsValid())
+			{
+				Snapshot.Layout = InstanceData.Layout.Get();
+				Snapshot.LayoutBytes = sizeof(FNTTTextLayout) + InstanceData.Layout->GetAllocatedSize();
+				Snapshot.NumCharacters = InstanceData.Layout->GetCharacterCount();
+			}
+			if (InstanceData.GlyphTable.IsValid())
+			{
+				Snapshot.GlyphTableId = InstanceData.GlyphTable->TableId;
+				Snapshot.GlyphTableBytes = InstanceData.GlyphTable->GetAllocatedSize();
+			}
+			Snapshot.CPUBytes = sizeof(FNDIFontUVInfoInstanceData) + Snapshot.LayoutBytes + InstanceData.GetRetiredLayoutBytes()
+				+ InstanceData.StreamingWindowText.GetAllocatedSize();
+			if (InstanceData.EntryPlacements.IsValid())
+			{
+				Snapshot.EntryPlacements = InstanceData.EntryPlacements.Get();
+				Snapshot.CPUBytes += sizeof(FNTTEntryPlacements) + InstanceData.EntryPlacements->GetAllocatedSize();
+			}
+
+			FGPUQuery& Query = Queries.AddDefaulted_GetRef();
+			Query.Proxy = Entry.Proxy;
+			Query.InstanceID = Entry.InstanceID;
+		}
+	}
+
+	// Proxies outlive the instances registered with them, so every proxy is still alive when this runs
+	ENQUEUE_RENDER_COMMAND(NTTGatherInstanceMemory)
+	(
+		[&Queries](FRHICommandListImmediate& RHICmdList)
+		{
+			for (FGPUQuery& Query : Queries)
+			{
+				Query.Proxy->GetInstanceGPUBytes_RT(Query.InstanceID, Query.TextBytes, Query.GlyphBytes);
+			}
+		}
+	);
+	FlushRenderingCommands();
+
+	for (int32 Index = 0; Index < Snapshots.Num(); ++Index)
+	{
+		Snapshots[Index].GPUBytes = Queries[Index].TextBytes;
+		Snapshots[Index].GlyphBufferBytes = Queries[Index].GlyphBytes;
+	}
+	return Snapshots;
+}
+
+void FNTTInstanceRegistry::DumpInstances(FOutputDevice& Ar) const
+{
+	TArray<FNTTInstanceSnapshot> Snapshots = Gather();
+	Snapshots.Sort([](const FNTTInstanceSnapshot& A, const FNTTInstanceSnapshot& B)
+	{
+		return A.CPUBytes + A.GPUBytes > B.CPUBytes + B.GPUBytes;
+	});
+
+	Ar.Logf(TEXT("NTT: %d live instances. CPU includes the layout, which may be shared. GPU excludes the shared glyph buffer."), Snapshots.Num());
+	Ar.Logf(TEXT("%12s %12s %12s  %-32s %s"), TEXT("Chars"), TEXT("CPU KB"), TEXT("GPU KB"), TEXT("Font"), TEXT("System"));
+	for (const FNTTInstanceSnapshot& Snapshot : Snapshots)
+	{
+		Ar.Logf(TEXT("%12d %12.1f %12.1f  %-32s %s"), Snapshot.NumCharacters, NTTDiagnosticsPrivate::ToKB(Snapshot.CPUBytes),
+			NTTDiagnosticsPrivate::ToKB(Snapshot.GPUBytes), *Snapshot.FontName, *Snapshot.SystemName);
+	}
+}
+
+void FNTTInstanceRegistry::MemReport(FOutputDevice& Ar) const
+{
+	using namespace NTTDiagnosticsPrivate;
+
+	const TArray<FNTTInstanceSnapshot> Snapshots = Gather();
+
+	FMemoryGroup Total;
+	TMap<FString, FMemoryGroup> PerFont;
+	TMap<FString, FMemoryGroup> PerSystem;
+	for (const FNTTInstanceSnapshot& Snapshot : Snapshots)
+	{
+		Total.Add(Snapshot);
+		PerFont.FindOrAdd(Snapshot.FontName).Add(Snapshot);
+		PerSystem.FindOrAdd(Snapshot.SystemName).Add(Snapshot);
+	}
+
+	uint64 IdlePoolBytes = 0;
+	ENQUEUE_RENDER_COMMAND(NTTGatherPoolMemory)
+	(
+		[&IdlePoolBytes](FRHICommandListImmediate& RHICmdList)
+		{
+			IdlePoolBytes = GNTTBufferPool.GetFreeBytes_RT();
+		}
+	);
+	FlushRenderingCommands();
+
+	const FNTTLayoutCacheStats CacheStats = FNTTLayoutCache::Get().GetStats();
+
+	Ar.Logf(TEXT("NTT memory: %d instances, %lld characters, %.1f KB CPU, %.1f KB GPU"),
+		Total.NumInstances, Total.NumCharacters, ToKB(Total.CPUBytes), ToKB(Total.GPUBytes));
+	Ar.Logf(TEXT("Shared layouts and glyph tables are counted once per group, so groups can add up to more than the total."));
+
+	LogGroups(Ar, TEXT("Per font"), PerFont);
+	LogGroups(Ar, TEXT("Per system"), PerSystem);
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("Layout cache (CPU): %d entries, %.1f KB"), CacheStats.NumEntries, ToKB(CacheStats.NumBytes));
+	Ar.Logf(TEXT("Idle pooled buffers (GPU): %.1f KB"), ToKB(IdlePoolBytes));
+}
@@ -0,0 +1,293 @@
+// Property of Lucian Tranc
+
+#include "NTTFontGlyphCache.h"
+#include "NTTDataInterface.h"
+#include "NTTStats.h"
+#include "Engine/Font.h"
+#include "Engine/Texture2D.h"
+#include "UObject/UObjectGlobals.h"
+
+static std::atomic<uint32> GNTTNextGlyphTableId(1);
+
+void FNTTGlyphTable::BuildChannels()
+{
+	const int32 NumSlots = NumGlyphs() + 1;
+
+	Channels.USize.SetNumZeroed(NumSlots);
+	Channels.VSize.SetNumZeroed(NumSlots);
+	Channels.UStart.SetNumZeroed(NumSlots);
+	Channels.VStart.SetNumZeroed(NumSlots);
+	Channels.Width.SetNumZeroed(NumSlots);
+	Channels.Height.SetNumZeroed(NumSlots);
+
+	for (int32 GlyphIndex = 0; GlyphIndex < NumGlyphs(); ++GlyphIndex)
+	{
+		const FVector4f& UVRect = GlyphTextureUvs[GlyphIndex];
+		Channels.USize[GlyphIndex] = UVRect.X;
+		Channels.VSize[GlyphIndex] = UVRect.Y;
+		Channels.UStart[GlyphIndex] = UVRect.Z;
+		Channels.VStart[GlyphIndex] = UVRect.W;
+		Channels.Width[GlyphIndex] = GlyphSpriteSizes[GlyphIndex].X;
+		Channels.Height[GlyphIndex] = GlyphSpriteSizes[GlyphIndex].Y;
+	}
+}
+
+FNTTFontGlyphCache& FNTTFontGlyphCache::Get()
+{
+	static FNTTFontGlyphCache Instance;
+	return Instance;
+}
+
+void FNTTFontGlyphCache::Initialize()
+{
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FNTTFontGlyphCache::PurgeStaleEntries);
+#if WITH_EDITOR
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FNTTFontGlyphCache::OnObjectPropertyChanged);
+#endif
+}
+
+void FNTTFontGlyphCache::Shutdown()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
+	InvalidateAll();
+}
+
+FNTTGlyphTableRef FNTTFontGlyphCache::FindOrBuild(const UFont* FontAsset)
+{
+	const FIntPoint TextureSize = GetFontTextureSize(FontAsset);
+	const TObjectKey<UFont> Key(FontAsset);
+
+	{
+		FScopeLock Lock(&CacheLock);
+		if (const FCacheEntry* Entry = Entries.Find(Key))
+		{
+			if (Entry->Generation == Generation && Entry->TextureSize == TextureSize)
+			{
+				return Entry->Table;
+			}
+		}
+	}
+
+	// Build outside of the lock so that unrelated fonts don't wait on each other.
+	// If two threads race on the same font, the first table to be inserted wins.
+	FNTTGlyphTableRef NewTable = BuildTable(FontAsset);
+
+	FScopeLock Lock(&CacheLock);
+	FCacheEntry& Entry = Entries.FindOrAdd(Key);
+	if (Entry.Table.IsValid() && Entry.Generation == Generation && Entry.TextureSize == TextureSize)
+	{
+		return Entry.Table;
+	}
+
+	Entry.Table = NewTable;
+	Entry.TextureSize = TextureSize;
+	Entry.Generation = Generation;
+	return NewTable;
+}
+
+void FNTTFontGlyphCache::Invalidate(const UFont* FontAsset)
+{
+	FScopeLock Lock(&CacheLock);
+	Entries.Remove(TObjectKey<UFont>(FontAsset));
+}
+
+void FNTTFontGlyphCache::InvalidateAll()
+{
+	FScopeLock Lock(&CacheLock);
+	Entries.Empty();
+	++Generation;
+}
+
+void FNTTFontGlyphCache::PurgeStaleEntries()
+{
+	FScopeLock Lock(&CacheLock);
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Key().ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+#if WITH_EDITOR
+void FNTTFontGlyphCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (const UFont* Font = Cast<UFont>(Object))
+	{
+		UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT Glyph Cache: Font '%s' changed - invalidating cached glyph table"), *GetNameSafe(Font));
+		Invalidate(Font);
+	}
+}
+#endif
+
+FIntPoint FNTTFontGlyphCache::GetFontTextureSize(const UFont* FontAsset)
+{
+	if (FontAsset && FontAsset->Textures.Num() > 0)
+	{
+		if (const UTexture2D* FontTexture = Cast<UTexture2D>(FontAsset->Textures[0]))
+		{
+			return FIntPoint(FontTexture->GetSizeX(), FontTexture->GetSizeY());
+		}
+	}
+	return FIntPoint::ZeroValue;
+}
+
+FNTTGlyphTableRef FNTTFontGlyphCache::BuildTable(const UFont* FontAsset)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NTT_GlyphTableBuild);
+	CSV_SCOPED_TIMING_STAT(NTT, GlyphTableBuild);
+	LLM_SCOPE_BYTAG(NTT);
+
+	TSharedPtr<FNTTGlyphTable, ESPMode::ThreadSafe> Table = MakeShared<FNTTGlyphTable, ESPMode::ThreadSafe>();
+	Table->TableId = GNTTNextGlyphTableId.fetch_add(1);
+
+	// Only offline cached fonts have the Characters array populated
+	if (!FontAsset || FontAsset->FontCacheType != EFontCacheType::Offline)
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT DI: Font '%s' is invalid or not an offline cached font - Characters array will be empty"), *GetNameSafe(FontAsset));
+		Table->BuildChannels();
+		return Table;
+	}
+
+	// Try to get the first font texture so we can normalize glyph UVs into 0-1 space.
+	const FIntPoint TextureSize = GetFontTextureSize(FontAsset);
+
+	FVector2f InvTextureSize(1.0f, 1.0f);
+	if (FontAsset->Textures.Num() > 0 && FontAsset->Textures[0])
+	{
+		const float TexW = static_cast<float>(TextureSize.X);
+		const float TexH = static_cast<float>(TextureSize.Y);
+		if (TexW > 0.0f && TexH > 0.0f)
+		{
+			InvTextureSize = FVector2f(1.0f / TexW, 1.0f / TexH);
+		}
+		else
+		{
+			UE_LOG(LogNiagaraTextToolkit, Warning,
+				TEXT("NTT DI: Font '%s' texture has invalid size (%f x %f) - UVs will not be normalized"),
+				*GetNameSafe(FontAsset), TexW, TexH);
+		}
+	}
+	else
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning,
+			TEXT("NTT DI: Font '%s' has no textures - UVs will not be normalized"),
+			*GetNameSafe(FontAsset));
+	}
+
+	// Adds one glyph to the dense arrays and returns its index.
+	auto AddGlyph = [&Table, &InvTextureSize](const FFontCharacter& FontChar) -> int32
+	{
+		const float USizePx = static_cast<float>(FontChar.USize);
+		const float VSizePx = static_cast<float>(FontChar.VSize);
+		const float UStartPx = static_cast<float>(FontChar.StartU);
+		const float VStartPx = static_cast<float>(FontChar.StartV);
+
+		// Store sprite size in pixels for layout / particle sizing.
+		Table->GlyphSpriteSizes.Add(FVector2f(USizePx, VSizePx));
+		Table->MaxGlyphHeight = FMath::Max(Table->MaxGlyphHeight, VSizePx);
+
+		// Precompute normalized UVs so shaders/materials don't have to divide by texture resolution.
+		const float USizeNorm  = USizePx  * InvTextureSize.X;
+		const float VSizeNorm  = VSizePx  * InvTextureSize.Y;
+		const float UStartNorm = UStartPx * InvTextureSize.X;
+		const float VStartNorm = VStartPx * InvTextureSize.Y;
+
+		// Layout: (USize, VSize, UStart, VStart) in 0-1 texture space.
+		Table->GlyphTextureUvs.Add(FVector4f(USizeNorm, VSizeNorm, UStartNorm, VStartNorm));
+		return Table->GlyphVerticalOffsets.Add(FontChar.VerticalOffset);
+	};
+
+	auto MapCodePoint = [&Table](uint32 CodePoint, int32 GlyphIndex)
+	{
+		if (CodePoint < (uint32)FNTTGlyphTable::NumLatin1CodePoints)
+		{
+			Table->Latin1GlyphIndices[CodePoint] = GlyphIndex;
+		}
+		else
+		{
+			Table->ExtendedGlyphIndices.Add(CodePoint, GlyphIndex);
+		}
+	};
+
+	const TArray<FFontCharacter>& Characters = FontAsset->Characters;
+
+	if (FontAsset->IsRemapped)
+	{
+		// Remapped fonts store only the imported characters; CharRemap maps code points to Characters indices.
+		// Several code points can share one entry, so glyphs are deduplicated by entry.
+		TMap<int32, int32> EntryToGlyphIndex;
+		EntryToGlyphIndex.Reserve(FontAsset->CharRemap.Num());
+		Table->GlyphSpriteSizes.Reserve(Characters.Num());
+		Table->GlyphTextureUvs.Reserve(Characters.Num());
+		Table->GlyphVerticalOffsets.Reserve(Characters.Num());
+
+		for (const TPair<uint16, uint16>& Remap : FontAsset->CharRemap)
+		{
+			const int32 EntryIndex = Remap.Value;
+			if (!Characters.IsValidIndex(EntryIndex))
+			{
+				continue;
+			}
+
+			int32 GlyphIndex = INDEX_NONE;
+			if (const int32* Existing = EntryToGlyphIndex.Find(EntryIndex))
+			{
+				GlyphIndex = *Existing;
+			}
+			else
+			{
+				GlyphIndex = AddGlyph(Characters[EntryIndex]);
+				EntryToGlyphIndex.Add(EntryIndex, GlyphIndex);
+			}
+
+			MapCodePoint(Remap.Key, GlyphIndex);
+		}
+	}
+	else
+	{
+		// Non-remapped fonts index Characters directly by code point, which leaves empty entries for every code point
+		// that wasn't imported. The layout treats those as zero-width glyphs: they stay inline, take kerning and their
+		// vertical offset counts toward the line height. Empty entries only differ by that offset, so they share one glyph per offset.
+		TMap<int32, int32> EmptyGlyphIndices;
+		for (int32 CodePoint = 0; CodePoint < Characters.Num(); ++CodePoint)
+		{
+			const FFontCharacter& FontChar = Characters[CodePoint];
+			int32 GlyphIndex = INDEX_NONE;
+			if (FontChar.USize == 0 && FontChar.VSize == 0)
+			{
+				if (const int32* Existing = EmptyGlyphIndices.Find(FontChar.VerticalOffset))
+				{
+					GlyphIndex = *Existing;
+				}
+				else
+				{
+					GlyphIndex = AddGlyph(FontChar);
+					EmptyGlyphIndices.Add(FontChar.VerticalOffset, GlyphIndex);
+				}
+			}
+			else
+			{
+				GlyphIndex = AddGlyph(FontChar);
+			}
+
+			MapCodePoint((uint32)CodePoint, GlyphIndex);
+		}
+	}
+
+	Table->GlyphSpriteSizes.Shrink();
+	Table->GlyphTextureUvs.Shrink();
+	Table->GlyphVerticalOffsets.Shrink();
+
+	Table->Kerning = FontAsset->Kerning;
+	Table->BuildChannels();
+
+	UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT Glyph Cache: Built glyph table %u for font '%s' (%d glyphs from %d font characters)"),
+		Table->TableId, *GetNameSafe(FontAsset), Table->NumGlyphs(), Characters.Num());
+
+	return Table;
+}
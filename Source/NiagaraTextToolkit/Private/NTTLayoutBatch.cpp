@@ -0,0 +1,132 @@
+// Property of Lucian Tranc
+
+#include "NTTLayoutBatch.h"
+#include "NTTDataInterface.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTLayoutCache.h"
+#include "NTTStats.h"
+#include "Async/ParallelFor.h"
+
+namespace NTTLayoutBatchPrivate
+{
+	// One distinct layout that has to be built
+	struct FPendingLayout
+	{
+		int32 RequestIndex = INDEX_NONE;
+		FNTTGlyphTableRef GlyphTable;
+		FNTTTextLayoutRef Result;
+	};
+
+	// Per-worker scratch layout. The engine reserves for the whole input, so building into a reused scratch
+	// and copying out gives tightly sized results without reallocating per request.
+	struct FWorkerContext
+	{
+		FNTTTextLayout Scratch;
+	};
+}
+
+void FNTTLayoutBatch::Prewarm(TConstArrayView<FNTTLayoutParams> Requests, TArray<FNTTTextLayoutRef>* OutLayouts)
+{
+	using namespace NTTLayoutBatchPrivate;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(NTTLayoutBatch_Prewarm);
+
+	const int32 NumRequests = Requests.Num();
+	if (OutLayouts)
+	{
+		OutLayouts->Reset();
+		OutLayouts->SetNum(NumRequests);
+	}
+
+	if (NumRequests == 0)
+	{
+		return;
+	}
+
+	FNTTLayoutCache& LayoutCache = FNTTLayoutCache::Get();
+
+	// Resolve fonts once per distinct font and collect the layouts that aren't cached yet, without duplicates.
+	TMap<const UFont*, FNTTGlyphTableRef> GlyphTables;
+	TMap<FNTTLayoutCacheKey, int32> PendingByKey;
+	TArray<FPendingLayout> Pending;
+	TArray<int32> RequestToPending;
+	RequestToPending.Init(INDEX_NONE, NumRequests);
+
+	for (int32 RequestIndex = 0; RequestIndex < NumRequests; ++RequestIndex)
+	{
+		const FNTTLayoutParams& Params = Requests[RequestIndex];
+
+		FNTTGlyphTableRef* GlyphTable = GlyphTables.Find(Params.FontAsset);
+		if (GlyphTable == nullptr)
+		{
+			GlyphTable = &GlyphTables.Add(Params.FontAsset, FNTTFontGlyphCache::Get().FindOrBuild(Params.FontAsset));
+		}
+
+		FNTTLayoutCacheKey Key(**GlyphTable, Params);
+		if (const int32* ExistingPending = PendingByKey.Find(Key))
+		{
+			RequestToPending[RequestIndex] = *ExistingPending;
+			continue;
+		}
+
+		if (FNTTTextLayoutRef Cached = LayoutCache.Find(**GlyphTable, Params))
+		{
+			if (OutLayouts)
+			{
+				(*OutLayouts)[RequestIndex] = MoveTemp(Cached);
+			}
+			continue;
+		}
+
+		const int32 PendingIndex = Pending.AddDefaulted();
+		Pending[PendingIndex].RequestIndex = RequestIndex;
+		Pending[PendingIndex].GlyphTable = *GlyphTable;
+		PendingByKey.Add(MoveTemp(Key), PendingIndex);
+		RequestToPending[RequestIndex] = PendingIndex;
+	}
+
+	if (Pending.Num() > 0)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(NTTLayoutBatch_Build);
+
+		TArray<FWorkerContext> WorkerContexts;
+		ParallelForWithTaskContext(WorkerContexts, Pending.Num(), [&Pending, Requests](FWorkerContext& Worker, int32 PendingIndex)
+		{
+			LLM_SCOPE_BYTAG(NTT);
+			FPendingLayout& Item = Pending[PendingIndex];
+			const FNTTLayoutParams& Params = Requests[Item.RequestIndex];
+
+			FNTTTextLayoutEngine::Build(*Item.GlyphTable, Params, Params.InputText, Worker.Scratch);
+			Item.Result = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>(Worker.Scratch);
+		});
+
+		SIZE_T PendingBytes = 0;
+		for (const FPendingLayout& Item : Pending)
+		{
+			const FNTTLayoutParams& Params = Requests[Item.RequestIndex];
+			PendingBytes += FNTTLayoutCache::GetEntryBytes(Params.InputText, *Item.Result);
+			LayoutCache.Add(*Item.GlyphTable, Params, Item.Result);
+		}
+
+		// The cache is the only thing holding the results for callers that don't take OutLayouts, so a batch larger than
+		// the cache evicts its own first layouts before their systems spawn
+		const FNTTLayoutCacheStats Stats = LayoutCache.GetStats();
+		if (Pending.Num() > Stats.Capacity || PendingBytes > Stats.MaxBytes)
+		{
+			UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT Layout Batch: Prewarmed %d layouts (%llu KB), but the layout cache only holds %d layouts and %llu KB. ")
+				TEXT("Some of them were evicted again and will be laid out when their systems spawn. Raise ntt.LayoutCache.Capacity or ntt.LayoutCache.MaxBytes, prewarm fewer texts at once, or keep the layouts returned in OutLayouts."),
+				Pending.Num(), (uint64)(PendingBytes / 1024), Stats.Capacity, (uint64)(Stats.MaxBytes / 1024));
+		}
+	}
+
+	if (OutLayouts)
+	{
+		for (int32 RequestIndex = 0; RequestIndex < NumRequests; ++RequestIndex)
+		{
+			if (RequestToPending[RequestIndex] != INDEX_NONE)
+			{
+				(*OutLayouts)[RequestIndex] = Pending[RequestToPending[RequestIndex]].Result;
+			}
+		}
+	}
+}
@@ -0,0 +1,200 @@
+// Property of Lucian Tranc
+
+#include "NTTLayoutCache.h"
+#include "NTTDataInterface.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTStats.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 GNTTLayoutCacheCapacity = 256;
+static FAutoConsoleVariableRef CVarNTTLayoutCacheCapacity(
+	TEXT("ntt.LayoutCache.Capacity"),
+	GNTTLayoutCacheCapacity,
+	TEXT("Maximum number of finished text layouts kept in the NTT layout cache. 0 disables the cache."),
+	ECVF_Default);
+
+static int32 GNTTLayoutCacheMaxBytes = 4 * 1024 * 1024;
+static FAutoConsoleVariableRef CVarNTTLayoutCacheMaxBytes(
+	TEXT("ntt.LayoutCache.MaxBytes"),
+	GNTTLayoutCacheMaxBytes,
+	TEXT("Memory budget of the NTT layout cache in bytes. Layouts larger than this are never cached."),
+	ECVF_Default);
+
+FNTTLayoutCacheKey::FNTTLayoutCacheKey(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params)
+	: GlyphTableId(GlyphTable.TableId)
+	, Text(Params.InputText)
+	, HorizontalAlignment((uint8)Params.HorizontalAlignment)
+	, VerticalAlignment((uint8)Params.VerticalAlignment)
+	, VerticalOffset(Params.VerticalOffset)
+	, KerningOffset(Params.KerningOffset)
+	, WhitespaceWidthMultiplier(Params.WhitespaceWidthMultiplier)
+	, bFilterWhitespaceCharacters(Params.bFilterWhitespaceCharacters)
+{
+	Hash = GetTypeHash(Text);
+	Hash = HashCombine(Hash, GlyphTableId);
+	Hash = HashCombine(Hash, (uint32)HorizontalAlignment | ((uint32)VerticalAlignment << 8) | ((uint32)bFilterWhitespaceCharacters << 16));
+	Hash = HashCombine(Hash, GetTypeHash(VerticalOffset));
+	Hash = HashCombine(Hash, GetTypeHash(KerningOffset));
+	Hash = HashCombine(Hash, GetTypeHash(WhitespaceWidthMultiplier));
+}
+
+FNTTLayoutCache& FNTTLayoutCache::Get()
+{
+	static FNTTLayoutCache Instance;
+	return Instance;
+}
+
+FNTTLayoutCache::FNTTLayoutCache()
+	: Entries(FMath::Max(GNTTLayoutCacheCapacity, 1))
+{
+}
+
+FNTTTextLayoutRef FNTTLayoutCache::FindOrBuild(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params)
+{
+	if (GNTTLayoutCacheCapacity <= 0)
+	{
+		return UNTTDataInterface::BuildLayout(GlyphTable, Params);
+	}
+
+	FNTTLayoutCacheKey Key(GlyphTable, Params);
+
+	{
+		FScopeLock Lock(&CacheLock);
+		if (FNTTTextLayoutRef Cached = FindLocked(Key))
+		{
+			return Cached;
+		}
+	}
+
+	// Build outside of the lock so that other instances can keep hitting the cache meanwhile.
+	FNTTTextLayoutRef Layout = UNTTDataInterface::BuildLayout(GlyphTable, Params);
+
+	FScopeLock Lock(&CacheLock);
+	AddLocked(MoveTemp(Key), Layout);
+	return Layout;
+}
+
+FNTTTextLayoutRef FNTTLayoutCache::Find(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params)
+{
+	if (GNTTLayoutCacheCapacity <= 0)
+	{
+		return nullptr;
+	}
+
+	const FNTTLayoutCacheKey Key(GlyphTable, Params);
+
+	FScopeLock Lock(&CacheLock);
+	return FindLocked(Key);
+}
+
+void FNTTLayoutCache::Add(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, FNTTTextLayoutRef Layout)
+{
+	if (GNTTLayoutCacheCapacity <= 0 || !Layout.IsValid())
+	{
+		return;
+	}
+
+	FNTTLayoutCacheKey Key(GlyphTable, Params);
+
+	FScopeLock Lock(&CacheLock);
+	AddLocked(MoveTemp(Key), MoveTemp(Layout));
+}
+
+void FNTTLayoutCache::Empty()
+{
+	FScopeLock Lock(&CacheLock);
+	Entries.Empty(FMath::Max(GNTTLayoutCacheCapacity, 1));
+	NumBytes = 0;
+	SET_MEMORY_STAT(STAT_NTT_LayoutCacheMemory, 0);
+}
+
+FNTTLayoutCacheStats FNTTLayoutCache::GetStats() const
+{
+	FScopeLock Lock(&CacheLock);
+
+	FNTTLayoutCacheStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Evictions = Evictions;
+	Stats.NumEntries = Entries.Num();
+	Stats.NumBytes = NumBytes;
+	Stats.Capacity = FMath::Max(GNTTLayoutCacheCapacity, 1);
+	Stats.MaxBytes = (SIZE_T)FMath::Max(GNTTLayoutCacheMaxBytes, 0);
+	return Stats;
+}
+
+SIZE_T FNTTLayoutCache::GetEntryBytes(const FString& Text, const FNTTTextLayout& Layout)
+{
+	return sizeof(FCacheEntry) + sizeof(FNTTTextLayout) + Text.GetAllocatedSize() + Layout.GetAllocatedSize();
+}
+
+FNTTTextLayoutRef FNTTLayoutCache::FindLocked(const FNTTLayoutCacheKey& Key)
+{
+	ApplyCapacityLocked();
+
+	if (const FCacheEntry* Entry = Entries.FindAndTouch(Key))
+	{
+		++Hits;
+		return Entry->Layout;
+	}
+
+	++Misses;
+	return nullptr;
+}
+
+void FNTTLayoutCache::AddLocked(FNTTLayoutCacheKey&& Key, FNTTTextLayoutRef Layout)
+{
+	LLM_SCOPE_BYTAG(NTT);
+	ApplyCapacityLocked();
+
+	// Another thread may have added the same layout while we were building ours
+	if (Entries.Contains(Key))
+	{
+		return;
+	}
+
+	const SIZE_T EntryBytes = GetEntryBytes(Key.Text, *Layout);
+	const SIZE_T MaxBytes = (SIZE_T)FMath::Max(GNTTLayoutCacheMaxBytes, 0);
+	if (EntryBytes > MaxBytes)
+	{
+		return;
+	}
+
+	// Make room ourselves so the byte count stays in sync; TLruCache would otherwise silently drop the oldest entry.
+	EvictLocked(Entries.Max() - 1, MaxBytes - EntryBytes);
+
+	FCacheEntry Entry;
+	Entry.Layout = MoveTemp(Layout);
+	Entry.NumBytes = EntryBytes;
+	Entries.Add(MoveTemp(Key), MoveTemp(Entry));
+	NumBytes += EntryBytes;
+	SET_MEMORY_STAT(STAT_NTT_LayoutCacheMemory, NumBytes);
+}
+
+void FNTTLayoutCache::EvictLocked(int32 MaxEntries, SIZE_T MaxBytes)
+{
+	while (Entries.Num() > 0 && (Entries.Num() > MaxEntries || NumBytes > MaxBytes))
+	{
+		const FCacheEntry Removed = Entries.RemoveLeastRecent();
+		NumBytes -= Removed.NumBytes;
+		++Evictions;
+	}
+	SET_MEMORY_STAT(STAT_NTT_LayoutCacheMemory, NumBytes);
+}
+
+void FNTTLayoutCache::ApplyCapacityLocked()
+{
+	// Resizing a TLruCache drops its contents, so only do it when the CVar actually changed
+	const int32 Capacity = FMath::Max(GNTTLayoutCacheCapacity, 1);
+	if (Entries.Max() != Capacity)
+	{
+		Evictions += Entries.Num();
+		Entries.Empty(Capacity);
+		NumBytes = 0;
+		SET_MEMORY_STAT(STAT_NTT_LayoutCacheMemory, 0);
+	}
+	else
+	{
+		EvictLocked(Capacity, (SIZE_T)FMath::Max(GNTTLayoutCacheMaxBytes, 0));
+	}
+}
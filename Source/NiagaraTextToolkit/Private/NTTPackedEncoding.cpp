@@ -0,0 +1,273 @@
+// Property of Lucian Tranc
+
+#include "NTTPackedEncoding.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTTextLayout.h"
+#include "Math/Float16.h"
+
+static int32 GNTTCompactGPUEncoding = 0;
+static FAutoConsoleVariableRef CVarNTTCompactGPUEncoding(
+	TEXT("ntt.CompactGPUEncoding"),
+	GNTTCompactGPUEncoding,
+	TEXT("Uploads NTT text buffers with 16-bit indices and half precision positions where that is lossless, and glyph UVs as unorm16.\n")
+	TEXT("Applies to layouts uploaded and glyph buffers created after it is changed."),
+	ECVF_Default);
+
+static int32 GNTTCharacterRecords = 1;
+static FAutoConsoleVariableRef CVarNTTCharacterRecords(
+	TEXT("ntt.CharacterRecords"),
+	GNTTCharacterRecords,
+	TEXT("Uploads glyph index, position, line and word of every character as one uint4 record so GPU lookups take a single load.\n")
+	TEXT("Falls back to separate tables for texts with more than 65534 lines or glyphs. Applies to layouts uploaded after it is changed."),
+	ECVF_Default);
+
+namespace NTTPackedEncoding
+{
+	static FORCEINLINE void StoreBits(float* Dest, uint32 Bits)
+	{
+		FMemory::Memcpy(Dest, &Bits, sizeof(uint32));
+	}
+
+	static FORCEINLINE uint32 LoadBits(const float* Src)
+	{
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, Src, sizeof(uint32));
+		return Bits;
+	}
+
+	bool IsCompactEncodingEnabled()
+	{
+		return GNTTCompactGPUEncoding != 0;
+	}
+
+	ENTTTextEncoding ChooseTextEncoding(const FNTTTextLayout& Layout)
+	{
+		ENTTTextEncoding Encoding = ENTTTextEncoding::None;
+		if (!IsCompactEncodingEnabled())
+		{
+			return Encoding;
+		}
+
+		if (CanPack16(Layout.GlyphIndices))
+		{
+			Encoding |= ENTTTextEncoding::GlyphIndices16;
+		}
+		if (CanPackHalfExact(Layout.CharacterPositions))
+		{
+			Encoding |= ENTTTextEncoding::PositionsHalf;
+		}
+		// Indices are always below their counts
+		if (Layout.NumLines() <= MaxPacked16Value && Layout.NumWords() <= MaxPacked16Value)
+		{
+			Encoding |= ENTTTextEncoding::CharacterIndices16;
+		}
+		// Starts, counts and prefix sums never exceed the character count
+		if (Layout.NumCharacters() <= MaxPacked16Value)
+		{
+			Encoding |= ENTTTextEncoding::Tables16;
+		}
+		return Encoding;
+	}
+
+	bool ShouldUseCompactGlyphs(const FNTTGlyphTable& GlyphTable)
+	{
+		return IsCompactEncodingEnabled() && CanPackHalfExact(GlyphTable.GlyphSpriteSizes);
+	}
+
+	bool CanPack16(TConstArrayView<int32> Values)
+	{
+		for (const int32 Value : Values)
+		{
+			if (Value < INDEX_NONE || Value > MaxPacked16Value)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool CanPackHalfExact(TConstArrayView<FVector2f> Values)
+	{
+		for (const FVector2f& Value : Values)
+		{
+			if (UnpackHalf2(PackHalf2(Value.X, Value.Y)) != Value)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	uint32 PackUint16x2(int32 Low, int32 High)
+	{
+		return ((uint32)Low & 0xFFFFu) | (((uint32)High & 0xFFFFu) << 16);
+	}
+
+	int32 UnpackUint16(uint32 Bits, int32 HalfIndex)
+	{
+		const uint32 Value = (Bits >> (HalfIndex * 16)) & 0xFFFFu;
+		return (Value == 0xFFFFu) ? INDEX_NONE : (int32)Value;
+	}
+
+	uint32 PackHalf2(float Low, float High)
+	{
+		const FFloat16 LowHalf(Low);
+		const FFloat16 HighHalf(High);
+		return (uint32)LowHalf.Encoded | ((uint32)HighHalf.Encoded << 16);
+	}
+
+	FVector2f UnpackHalf2(uint32 Bits)
+	{
+		FFloat16 LowHalf;
+		FFloat16 HighHalf;
+		LowHalf.Encoded = (uint16)(Bits & 0xFFFFu);
+		HighHalf.Encoded = (uint16)(Bits >> 16);
+		return FVector2f(LowHalf.GetFloat(), HighHalf.GetFloat());
+	}
+
+	uint32 PackUnorm16x2(float Low, float High)
+	{
+		const uint32 LowBits = (uint32)FMath::RoundToInt(FMath::Clamp(Low, 0.0f, 1.0f) * 65535.0f);
+		const uint32 HighBits = (uint32)FMath::RoundToInt(FMath::Clamp(High, 0.0f, 1.0f) * 65535.0f);
+		return LowBits | (HighBits << 16);
+	}
+
+	FVector2f UnpackUnorm16x2(uint32 Bits)
+	{
+		return FVector2f((float)(Bits & 0xFFFFu) / 65535.0f, (float)(Bits >> 16) / 65535.0f);
+	}
+
+	void WriteInts(float* Dest, TConstArrayView<int32> Values, bool bPacked16)
+	{
+		const int32 Num = Values.Num();
+		if (!bPacked16)
+		{
+			FMemory::Memcpy(Dest, Values.GetData(), Num * sizeof(int32));
+			return;
+		}
+
+		int32 i = 0;
+		for (; i + 2 <= Num; i += 2)
+		{
+			StoreBits(&Dest[i / 2], PackUint16x2(Values[i], Values[i + 1]));
+		}
+		if (i < Num)
+		{
+			StoreBits(&Dest[i / 2], PackUint16x2(Values[i], 0));
+		}
+	}
+
+	int32 ReadInt(const float* Src, int32 Index, bool bPacked16)
+	{
+		if (bPacked16)
+		{
+			return UnpackUint16(LoadBits(&Src[Index >> 1]), Index & 1);
+		}
+		return (int32)LoadBits(&Src[Index]);
+	}
+
+	void WritePositions(float* Dest, TConstArrayView<FVector2f> Values, bool bHalf)
+	{
+		if (!bHalf)
+		{
+			FMemory::Memcpy(Dest, Values.GetData(), Values.Num() * sizeof(FVector2f));
+			return;
+		}
+
+		for (int32 i = 0; i < Values.Num(); ++i)
+		{
+			StoreBits(&Dest[i], PackHalf2(Values[i].X, Values[i].Y));
+		}
+	}
+
+	FVector2f ReadPosition(const float* Src, int32 Index, bool bHalf)
+	{
+		if (bHalf)
+		{
+			return UnpackHalf2(LoadBits(&Src[Index]));
+		}
+		return FVector2f(Src[Index * 2 + 0], Src[Index * 2 + 1]);
+	}
+
+	void WriteGlyphUVs(float* Dest, TConstArrayView<FVector4f> Values, bool bCompact)
+	{
+		if (!bCompact)
+		{
+			FMemory::Memcpy(Dest, Values.GetData(), Values.Num() * sizeof(FVector4f));
+			return;
+		}
+
+		for (int32 i = 0; i < Values.Num(); ++i)
+		{
+			StoreBits(&Dest[i * 2 + 0], PackUnorm16x2(Values[i].X, Values[i].Y));
+			StoreBits(&Dest[i * 2 + 1], PackUnorm16x2(Values[i].Z, Values[i].W));
+		}
+	}
+
+	FVector4f ReadGlyphUV(const float* Src, int32 GlyphIndex, bool bCompact)
+	{
+		if (bCompact)
+		{
+			const FVector2f Size = UnpackUnorm16x2(LoadBits(&Src[GlyphIndex * 2 + 0]));
+			const FVector2f Start = UnpackUnorm16x2(LoadBits(&Src[GlyphIndex * 2 + 1]));
+			return FVector4f(Size.X, Size.Y, Start.X, Start.Y);
+		}
+		return FVector4f(Src[GlyphIndex * 4 + 0], Src[GlyphIndex * 4 + 1], Src[GlyphIndex * 4 + 2], Src[GlyphIndex * 4 + 3]);
+	}
+
+	void WriteGlyphSizes(float* Dest, TConstArrayView<FVector2f> Values, bool bCompact)
+	{
+		WritePositions(Dest, Values, bCompact);
+	}
+
+	FVector2f ReadGlyphSize(const float* Src, int32 GlyphIndex, bool bCompact)
+	{
+		return ReadPosition(Src, GlyphIndex, bCompact);
+	}
+
+	bool AreCharacterRecordsEnabled()
+	{
+		return GNTTCharacterRecords != 0;
+	}
+
+	bool CanBuildCharacterRecords(const FNTTTextLayout& Layout)
+	{
+		return Layout.NumLines() <= MaxPacked16Value && CanPack16(Layout.GlyphIndices);
+	}
+
+	bool BuildCharacterRecords(const FNTTTextLayout& Layout, TArray<FUintVector4>& OutRecords)
+	{
+		OutRecords.Reset();
+		if (!CanBuildCharacterRecords(Layout))
+		{
+			return false;
+		}
+
+		OutRecords.SetNumUninitialized(Layout.NumCharacters());
+		WriteCharacterRecords(OutRecords.GetData(), Layout);
+		return true;
+	}
+
+	void WriteCharacterRecords(FUintVector4* Dest, const FNTTTextLayout& Layout)
+	{
+		const int32 NumChars = Layout.NumCharacters();
+		for (int32 i = 0; i < NumChars; ++i)
+		{
+			const FVector2f& Position = Layout.CharacterPositions[i];
+			FUintVector4& Record = Dest[i];
+			Record.X = LoadBits(&Position.X);
+			Record.Y = LoadBits(&Position.Y);
+			Record.Z = PackUint16x2(Layout.GlyphIndices[i], Layout.CharacterLineIndices[i]);
+			Record.W = (uint32)Layout.CharacterWordIndices[i];
+		}
+	}
+
+	void ReadCharacterRecord(const FUintVector4& Record, FVector2f& OutPosition, int32& OutGlyphIndex, int32& OutLineIndex, int32& OutWordIndex)
+	{
+		StoreBits(&OutPosition.X, Record.X);
+		StoreBits(&OutPosition.Y, Record.Y);
+		OutGlyphIndex = UnpackUint16(Record.Z, 0);
+		OutLineIndex = UnpackUint16(Record.Z, 1);
+		OutWordIndex = (int32)Record.W;
+	}
+}
@@ -0,0 +1,85 @@
+// Property of Lucian Tranc
+
+#include "NTTStats.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include <atomic>
+
+DEFINE_STAT(STAT_NTT_GlyphTableBuild);
+DEFINE_STAT(STAT_NTT_TextProcessing);
+DEFINE_STAT(STAT_NTT_Layout);
+DEFINE_STAT(STAT_NTT_ProvideRenderThreadData);
+DEFINE_STAT(STAT_NTT_ConsumeRenderThreadData);
+DEFINE_STAT(STAT_NTT_BufferUpload);
+
+DEFINE_STAT(STAT_NTT_LiveInstances);
+DEFINE_STAT(STAT_NTT_InstanceInits);
+DEFINE_STAT(STAT_NTT_LayoutUpdates);
+DEFINE_STAT(STAT_NTT_CharactersLaidOut);
+DEFINE_STAT(STAT_NTT_BufferUploads);
+DEFINE_STAT(STAT_NTT_InPlaceLayoutAllocations);
+
+DEFINE_STAT(STAT_NTT_InstanceMemory);
+DEFINE_STAT(STAT_NTT_LayoutCacheMemory);
+DEFINE_STAT(STAT_NTT_TextBufferMemory);
+DEFINE_STAT(STAT_NTT_PooledBufferMemory);
+DEFINE_STAT(STAT_NTT_GlyphBufferMemory);
+
+LLM_DEFINE_TAG(NTT);
+LLM_DEFINE_TAG(NTT_GPUBuffers, NAME_None, TEXT("NTT"));
+
+CSV_DEFINE_CATEGORY_MODULE(NIAGARATEXTTOOLKIT_API, NTT, true);
+
+UE_TRACE_CHANNEL_DEFINE(NTTChannel);
+
+// Insights counters, visible without enabling stats
+TRACE_DECLARE_INT_COUNTER(NTT_LiveInstances, TEXT("NTT/Live Instances"));
+TRACE_DECLARE_INT_COUNTER(NTT_CharactersLaidOut, TEXT("NTT/Characters Laid Out (Total)"));
+
+static std::atomic<int32> GNTTNumLiveInstances = 0;
+static std::atomic<int32> GNTTNumInPlaceLayoutAllocations = 0;
+
+namespace NTTStats
+{
+	void OnInstanceCreated(SIZE_T InstanceBytes)
+	{
+		const int32 NumLive = GNTTNumLiveInstances.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		INC_DWORD_STAT(STAT_NTT_LiveInstances);
+		INC_DWORD_STAT(STAT_NTT_InstanceInits);
+		INC_MEMORY_STAT_BY(STAT_NTT_InstanceMemory, InstanceBytes);
+		TRACE_COUNTER_SET(NTT_LiveInstances, NumLive);
+		CSV_CUSTOM_STAT(NTT, InstanceInits, 1, ECsvCustomStatOp::Accumulate);
+	}
+
+	void OnInstanceDestroyed(SIZE_T InstanceBytes)
+	{
+		const int32 NumLive = GNTTNumLiveInstances.fetch_sub(1, std::memory_order_relaxed) - 1;
+
+		DEC_DWORD_STAT(STAT_NTT_LiveInstances);
+		DEC_MEMORY_STAT_BY(STAT_NTT_InstanceMemory, InstanceBytes);
+		TRACE_COUNTER_SET(NTT_LiveInstances, NumLive);
+	}
+
+	int32 GetNumLiveInstances()
+	{
+		return GNTTNumLiveInstances.load(std::memory_order_relaxed);
+	}
+
+	void OnCharactersLaidOut(int32 NumCharacters)
+	{
+		INC_DWORD_STAT_BY(STAT_NTT_CharactersLaidOut, NumCharacters);
+		TRACE_COUNTER_ADD(NTT_CharactersLaidOut, NumCharacters);
+		CSV_CUSTOM_STAT(NTT, CharactersLaidOut, NumCharacters, ECsvCustomStatOp::Accumulate);
+	}
+
+	void OnInPlaceLayoutAllocated()
+	{
+		GNTTNumInPlaceLayoutAllocations.fetch_add(1, std::memory_order_relaxed);
+		INC_DWORD_STAT(STAT_NTT_InPlaceLayoutAllocations);
+	}
+
+	int32 GetNumInPlaceLayoutAllocations()
+	{
+		return GNTTNumInPlaceLayoutAllocations.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,655 @@
+// Property of Lucian Tranc
+
+#include "NTTTextLayout.h"
+#include "NTTDataInterface.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTStats.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 GNTTParallelLayoutThreshold = 256 * 1024;
+static FAutoConsoleVariableRef CVarNTTParallelLayoutThreshold(
+	TEXT("ntt.ParallelLayoutThreshold"),
+	GNTTParallelLayoutThreshold,
+	TEXT("Texts with at least this many characters are split at line breaks and laid out across worker threads.\n")
+	TEXT("The result is the same as laying them out on one thread. 0 disables it."),
+	ECVF_Default);
+
+namespace NTTTextLayoutPrivate
+{
+	// Smallest part of a text worth handing to another worker
+	static constexpr int32 MinCharactersPerChunk = 16 * 1024;
+
+	// Whitespace that ends a word and gets its width scaled by WhitespaceWidthMultiplier
+	FORCEINLINE bool IsWhitespaceChar(TCHAR Ch)
+	{
+		return Ch == ' '
+			|| Ch == '\t';
+	}
+
+	FORCEINLINE bool IsNewlineChar(TCHAR Ch)
+	{
+		return Ch == '\n'
+			|| Ch == '\r';
+	}
+
+	float GetAlignedLineStartX(ENTTTextHorizontalAlignment XAlignment, float Width)
+	{
+		switch (XAlignment)
+		{
+			case ENTTTextHorizontalAlignment::NTT_THA_Center:
+			{
+				return -Width * 0.5f;
+			}
+			case ENTTTextHorizontalAlignment::NTT_THA_Right:
+			{
+				return -Width;
+			}
+			default:
+			{
+				return 0.0f;
+			}
+		}
+	}
+
+	float GetAlignedBlockTop(ENTTTextVerticalAlignment YAlignment, float TotalHeight)
+	{
+		switch (YAlignment)
+		{
+			case ENTTTextVerticalAlignment::NTT_TVA_Center:
+			{
+				// Center of the whole block at Y=0.
+				return -(TotalHeight * 0.5f);
+			}
+			case ENTTTextVerticalAlignment::NTT_TVA_Bottom:
+			{
+				// Bottom of the last line at Y=0.
+				return -TotalHeight;
+			}
+			default:
+			{
+				// Top of first line at Y=0.
+				return 0.0f;
+			}
+		}
+	}
+
+	// Per-line values only known once the whole line (or the whole text) has been walked
+	struct FLineMetrics
+	{
+		float Width = 0.0f;
+		float Height = 0.0f;
+		float Top = 0.0f;
+	};
+
+	void ResetLayout(FNTTTextLayout& OutLayout)
+	{
+		OutLayout.GlyphIndices.Reset();
+		OutLayout.CharacterPositions.Reset();
+		OutLayout.CharacterLineIndices.Reset();
+		OutLayout.CharacterWordIndices.Reset();
+		OutLayout.LineStartIndices.Reset();
+		OutLayout.LineCharacterCounts.Reset();
+		OutLayout.WordStartIndices.Reset();
+		OutLayout.WordCharacterCounts.Reset();
+		OutLayout.WordCharacterCountPrefix.Reset();
+		OutLayout.WordWithTrailingWhitespacePrefix.Reset();
+		OutLayout.LineCharacterCountPrefix.Reset();
+		OutLayout.CharacterEntryIndices.Reset();
+		OutLayout.EntryStartIndices.Reset();
+		OutLayout.EntryCharacterCounts.Reset();
+		OutLayout.TotalTextHeight = 0.0f;
+	}
+
+	// Walks the lines of Text in a single pass. Measures lines, filters whitespace and builds the character, line and word
+	// tables of OutLayout. Positions are relative to each line's left edge and top; OutLines gets the width and height of every line.
+	// Text must start at the start of a line. Indices are relative to Text, which lets the parallel path walk parts of a text on their own.
+	template<typename AllocatorType>
+	void LayOutLines(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, FStringView Text, FNTTTextLayout& OutLayout, TArray<FLineMetrics, AllocatorType>& OutLines)
+	{
+		const TCHAR* Chars = Text.GetData();
+		const int32 TextLength = Text.Len();
+		const TArray<FVector2f>& GlyphSpriteSizes = GlyphTable.GlyphSpriteSizes;
+		const TArray<int32>& GlyphVerticalOffsets = GlyphTable.GlyphVerticalOffsets;
+		const float CharIncrement = static_cast<float>(GlyphTable.Kerning) + Params.KerningOffset;
+		const float WhitespaceWidthMultiplier = Params.WhitespaceWidthMultiplier;
+		const bool bFilterWhitespace = Params.bFilterWhitespaceCharacters;
+
+		OutLayout.GlyphIndices.Reserve(TextLength);
+		OutLayout.CharacterPositions.Reserve(TextLength);
+		OutLayout.CharacterLineIndices.Reserve(TextLength);
+		OutLayout.CharacterWordIndices.Reserve(TextLength);
+
+		bool bInsideWord = false;
+		int32 CurrentWordStartIndex = INDEX_NONE;
+		int32 CurrentWordCharCount = 0;
+
+		auto EndWord = [&]()
+		{
+			if (bInsideWord)
+			{
+				bInsideWord = false;
+				OutLayout.WordStartIndices.Add(CurrentWordStartIndex);
+				OutLayout.WordCharacterCounts.Add(CurrentWordCharCount);
+			}
+		};
+
+		// Appends one output character along with the line and word it belongs to
+		auto AddCharacter = [&OutLayout](int32 GlyphIndex, const FVector2f& Position, bool bIsWhitespace)
+		{
+			OutLayout.GlyphIndices.Add(GlyphIndex);
+			OutLayout.CharacterPositions.Add(Position);
+			// The current line and word are only added to their tables once they end
+			OutLayout.CharacterLineIndices.Add(OutLayout.LineStartIndices.Num());
+			// Whitespace belongs to the word before it (INDEX_NONE before the first word)
+			OutLayout.CharacterWordIndices.Add(bIsWhitespace ? OutLayout.WordStartIndices.Num() - 1 : OutLayout.WordStartIndices.Num());
+		};
+
+		int32 Index = 0;
+		while (Index < TextLength)
+		{
+			const int32 LineStartIndex = OutLayout.GlyphIndices.Num();
+			float LineX = 0.0f;
+			float MaxBottom = 0.0f;
+
+			// Walk one logical line. Positions are written relative to the line's left edge and top.
+			while (Index < TextLength && !IsNewlineChar(Chars[Index]))
+			{
+				const TCHAR Ch = Chars[Index++];
+				const bool bIsWhitespace = IsWhitespaceChar(Ch);
+
+				if (bIsWhitespace)
+				{
+					EndWord();
+				}
+				else
+				{
+					if (!bInsideWord)
+					{
+						bInsideWord = true;
+						CurrentWordStartIndex = OutLayout.GlyphIndices.Num();
+						CurrentWordCharCount = 0;
+					}
+					CurrentWordCharCount++;
+				}
+
+				const int32 GlyphIndex = GlyphTable.FindGlyphIndex(static_cast<uint32>(Ch));
+				const bool bOutput = !(bFilterWhitespace && bIsWhitespace);
+
+				// Characters without glyph data don't advance the line and stay at (0,0)
+				if (GlyphIndex == INDEX_NONE)
+				{
+					if (bOutput)
+					{
+						AddCharacter(INDEX_NONE, FVector2f(0.0f, 0.0f), bIsWhitespace);
+					}
+					continue;
+				}
+
+				const FVector2f& GlyphSize = GlyphSpriteSizes[GlyphIndex];
+				const float SizeX = bIsWhitespace ? GlyphSize.X * WhitespaceWidthMultiplier : GlyphSize.X;
+				const float SizeY = GlyphSize.Y;
+				const float TopY = static_cast<float>(GlyphVerticalOffsets[GlyphIndex]); // how far from the line's origin its top is
+
+				MaxBottom = FMath::Max(MaxBottom, TopY + SizeY);
+
+				if (bOutput)
+				{
+					AddCharacter(GlyphIndex, FVector2f(LineX + SizeX * 0.5f, TopY + SizeY * 0.5f), bIsWhitespace);
+				}
+
+				LineX += SizeX;
+
+				// If we have another non-whitespace character on this line, add kerning.
+				if (Index < TextLength && !IsNewlineChar(Chars[Index]) && !FChar::IsWhitespace(Chars[Index]))
+				{
+					LineX += CharIncrement;
+				}
+			}
+
+			// Consume the line break. CRLF counts as a single newline.
+			if (Index < TextLength)
+			{
+				if (Chars[Index] == '\r' && Index + 1 < TextLength && Chars[Index + 1] == '\n')
+				{
+					++Index;
+				}
+				++Index;
+			}
+
+			FLineMetrics& Line = OutLines.AddDefaulted_GetRef();
+			Line.Width = LineX;
+			Line.Height = (MaxBottom > 0.0f) ? MaxBottom : GlyphTable.MaxGlyphHeight;
+
+			OutLayout.LineStartIndices.Add(LineStartIndex);
+			OutLayout.LineCharacterCounts.Add(OutLayout.GlyphIndices.Num() - LineStartIndex);
+
+			// Newline breaks words in both modes. A trailing newline doesn't start another line.
+			if (Index < TextLength)
+			{
+				EndWord();
+			}
+		}
+
+		EndWord();
+	}
+
+	// Stacks the lines from the top of the block and returns the total height
+	template<typename AllocatorType>
+	float PlaceLines(const FNTTLayoutParams& Params, TArray<FLineMetrics, AllocatorType>& Lines)
+	{
+		float TotalHeight = 0.0f;
+		for (int32 LineIdx = 0; LineIdx < Lines.Num(); ++LineIdx)
+		{
+			Lines[LineIdx].Top = TotalHeight;
+			TotalHeight += Lines[LineIdx].Height;
+
+			if (LineIdx + 1 < Lines.Num())
+			{
+				TotalHeight += Params.VerticalOffset;
+			}
+		}
+		return TotalHeight;
+	}
+
+	// Splits Text into about one chunk per worker thread. Chunks start right after a line break, so every chunk
+	// holds whole lines. Texts without enough line breaks end up with fewer chunks, or one.
+	void FindChunkStarts(FStringView Text, TArray<int32, TInlineAllocator<16>>& OutChunkStarts)
+	{
+		const int32 TextLength = Text.Len();
+		const int32 NumChunks = FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, FMath::Max(TextLength / MinCharactersPerChunk, 1));
+		const TCHAR* Chars = Text.GetData();
+
+		OutChunkStarts.Add(0);
+		for (int32 ChunkIdx = 1; ChunkIdx < NumChunks; ++ChunkIdx)
+		{
+			int32 Index = FMath::Max(static_cast<int32>(static_cast<int64>(TextLength) * ChunkIdx / NumChunks), OutChunkStarts.Last());
+			while (Index < TextLength && !IsNewlineChar(Chars[Index]))
+			{
+				++Index;
+			}
+			if (Index < TextLength && Chars[Index] == '\r' && Index + 1 < TextLength && Chars[Index + 1] == '\n')
+			{
+				++Index;
+			}
+
+			// Nothing left to split after the last line break
+			if (Index + 1 >= TextLength)
+			{
+				break;
+			}
+			OutChunkStarts.Add(Index + 1);
+		}
+	}
+
+	// Lays out a text that was split into chunks of whole lines on worker threads. The result is the same as the serial path:
+	// chunks are walked with local indices, then merged with their indices offset and their lines placed in order.
+	void BuildParallel(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, FStringView Text, TConstArrayView<int32> ChunkStarts, FNTTTextLayout& OutLayout)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(NTTTextLayout_BuildParallel);
+
+		struct FChunk
+		{
+			FNTTTextLayout Layout;
+			TArray<FLineMetrics> Lines;
+			int32 CharBase = 0;
+			int32 LineBase = 0;
+			int32 WordBase = 0;
+		};
+
+		const int32 NumChunks = ChunkStarts.Num();
+		TArray<FChunk> Chunks;
+		Chunks.SetNum(NumChunks);
+
+		// Every chunk starts at a line start and words never cross a line break, so the chunks can be walked
+		// independently with chunk-local indices and line-local positions.
+		ParallelFor(NumChunks, [&](int32 ChunkIdx)
+		{
+			const int32 Start = ChunkStarts[ChunkIdx];
+			const int32 End = (ChunkIdx + 1 < NumChunks) ? ChunkStarts[ChunkIdx + 1] : Text.Len();
+			LLM_SCOPE_BYTAG(NTT);
+			LayOutLines(GlyphTable, Params, Text.Mid(Start, End - Start), Chunks[ChunkIdx].Layout, Chunks[ChunkIdx].Lines);
+		});
+
+		int32 TotalChars = 0;
+		int32 TotalLines = 0;
+		int32 TotalWords = 0;
+		for (FChunk& Chunk : Chunks)
+		{
+			Chunk.CharBase = TotalChars;
+			Chunk.LineBase = TotalLines;
+			Chunk.WordBase = TotalWords;
+			TotalChars += Chunk.Layout.NumCharacters();
+			TotalLines += Chunk.Layout.NumLines();
+			TotalWords += Chunk.Layout.NumWords();
+		}
+
+		// Line tops are a running sum, so they are placed serially in the same order as the serial path
+		// to get the same float results.
+		TArray<FLineMetrics> Lines;
+		Lines.Reserve(TotalLines);
+		for (const FChunk& Chunk : Chunks)
+		{
+			Lines.Append(Chunk.Lines);
+		}
+
+		const float TotalHeight = PlaceLines(Params, Lines);
+		const float BlockTop = GetAlignedBlockTop(Params.VerticalAlignment, TotalHeight);
+
+		OutLayout.GlyphIndices.SetNumUninitialized(TotalChars);
+		OutLayout.CharacterPositions.SetNumUninitialized(TotalChars);
+		OutLayout.CharacterLineIndices.SetNumUninitialized(TotalChars);
+		OutLayout.CharacterWordIndices.SetNumUninitialized(TotalChars);
+		OutLayout.LineStartIndices.SetNumUninitialized(TotalLines);
+		OutLayout.LineCharacterCounts.SetNumUninitialized(TotalLines);
+		OutLayout.WordStartIndices.SetNumUninitialized(TotalWords);
+		OutLayout.WordCharacterCounts.SetNumUninitialized(TotalWords);
+
+		// Copy every chunk to its place, offsetting its indices and moving its lines to their aligned origins
+		ParallelFor(NumChunks, [&](int32 ChunkIdx)
+		{
+			const FChunk& Chunk = Chunks[ChunkIdx];
+			const FNTTTextLayout& Part = Chunk.Layout;
+			const int32 NumPartChars = Part.NumCharacters();
+
+			FMemory::Memcpy(OutLayout.GlyphIndices.GetData() + Chunk.CharBase, Part.GlyphIndices.GetData(), NumPartChars * sizeof(int32));
+			FMemory::Memcpy(OutLayout.LineCharacterCounts.GetData() + Chunk.LineBase, Part.LineCharacterCounts.GetData(), Part.NumLines() * sizeof(int32));
+			FMemory::Memcpy(OutLayout.WordCharacterCounts.GetData() + Chunk.WordBase, Part.WordCharacterCounts.GetData(), Part.NumWords() * sizeof(int32));
+
+			for (int32 CharIdx = 0; CharIdx < NumPartChars; ++CharIdx)
+			{
+				// INDEX_NONE word indices mean "the word before this chunk's first word", which is WordBase - 1
+				OutLayout.CharacterLineIndices[Chunk.CharBase + CharIdx] = Part.CharacterLineIndices[CharIdx] + Chunk.LineBase;
+				OutLayout.CharacterWordIndices[Chunk.CharBase + CharIdx] = Part.CharacterWordIndices[CharIdx] + Chunk.WordBase;
+			}
+
+			for (int32 WordIdx = 0; WordIdx < Part.NumWords(); ++WordIdx)
+			{
+				OutLayout.WordStartIndices[Chunk.WordBase + WordIdx] = Part.WordStartIndices[WordIdx] + Chunk.CharBase;
+			}
+
+			for (int32 LineIdx = 0; LineIdx < Part.NumLines(); ++LineIdx)
+			{
+				const FLineMetrics& Line = Lines[Chunk.LineBase + LineIdx];
+				const FVector2f LineOrigin(GetAlignedLineStartX(Params.HorizontalAlignment, Line.Width), Line.Top + BlockTop);
+				const int32 Start = Part.LineStartIndices[LineIdx];
+				const int32 End = Start + Part.LineCharacterCounts[LineIdx];
+
+				OutLayout.LineStartIndices[Chunk.LineBase + LineIdx] = Start + Chunk.CharBase;
+
+				for (int32 CharIdx = Start; CharIdx < End; ++CharIdx)
+				{
+					FVector2f Position = Part.CharacterPositions[CharIdx];
+					if (Part.GlyphIndices[CharIdx] != INDEX_NONE)
+					{
+						Position += LineOrigin;
+					}
+					OutLayout.CharacterPositions[Chunk.CharBase + CharIdx] = Position;
+				}
+			}
+		});
+
+		OutLayout.TotalTextHeight = TotalHeight;
+		OutLayout.BuildPrefixSums();
+	}
+}
+
+void FNTTTextLayout::BuildPrefixSums()
+{
+	const int32 NumWordEntries = NumWords();
+	const int32 NumLineEntries = NumLines();
+
+	WordCharacterCountPrefix.SetNumUninitialized(NumWordEntries + 1);
+	WordWithTrailingWhitespacePrefix.SetNumUninitialized(NumWordEntries + 1);
+	LineCharacterCountPrefix.SetNumUninitialized(NumLineEntries + 1);
+
+	LineCharacterCountPrefix[0] = 0;
+	for (int32 LineIdx = 0; LineIdx < NumLineEntries; ++LineIdx)
+	{
+		LineCharacterCountPrefix[LineIdx + 1] = LineCharacterCountPrefix[LineIdx] + LineCharacterCounts[LineIdx];
+	}
+
+	// Every character belongs to a line, so this also works for counts-only layouts
+	const int32 NumChars = LineCharacterCountPrefix[NumLineEntries];
+
+	WordCharacterCountPrefix[0] = 0;
+	WordWithTrailingWhitespacePrefix[0] = 0;
+	for (int32 WordIdx = 0; WordIdx < NumWordEntries; ++WordIdx)
+	{
+		// Trailing whitespace is everything between the end of this word and the start of the next one (or the end of the text)
+		const int32 WordEnd = WordStartIndices[WordIdx] + WordCharacterCounts[WordIdx];
+		const int32 NextWordStart = (WordIdx + 1 < NumWordEntries) ? WordStartIndices[WordIdx + 1] : NumChars;
+		const int32 TrailingWhitespace = FMath::Max(0, NextWordStart - WordEnd);
+
+		WordCharacterCountPrefix[WordIdx + 1] = WordCharacterCountPrefix[WordIdx] + WordCharacterCounts[WordIdx];
+		WordWithTrailingWhitespacePrefix[WordIdx + 1] = WordWithTrailingWhitespacePrefix[WordIdx] + WordCharacterCounts[WordIdx] + TrailingWhitespace;
+	}
+}
+
+void FNTTTextLayoutEngine::Build(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, FStringView Text, FNTTTextLayout& OutLayout)
+{
+	using namespace NTTTextLayoutPrivate;
+
+	SCOPE_CYCLE_COUNTER(STAT_NTT_Layout);
+	CSV_SCOPED_TIMING_STAT(NTT, Layout);
+	LLM_SCOPE_BYTAG(NTT);
+
+	ResetLayout(OutLayout);
+	OutLayout.bFilterWhitespaceCharactersValue = Params.bFilterWhitespaceCharacters;
+	OutLayout.WindowFirstLine = Params.WindowFirstLine;
+	OutLayout.DocumentLineCount = Params.DocumentLineCount;
+
+	const int32 TextLength = Text.Len();
+	NTTStats::OnCharactersLaidOut(TextLength);
+
+	// Empty text is a single empty line
+	if (TextLength <= 0)
+	{
+		OutLayout.LineStartIndices.Add(0);
+		OutLayout.LineCharacterCounts.Add(0);
+		OutLayout.BuildPrefixSums();
+		return;
+	}
+
+	// Without glyphs nothing can be placed, so there is no layout at all
+	if (!GlyphTable.IsValid())
+	{
+		OutLayout.BuildPrefixSums();
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<16>> ChunkStarts;
+	if (GNTTParallelLayoutThreshold > 0 && TextLength >= GNTTParallelLayoutThreshold)
+	{
+		FindChunkStarts(Text, ChunkStarts);
+	}
+
+	if (ChunkStarts.Num() > 1)
+	{
+		BuildParallel(GlyphTable, Params, Text, ChunkStarts, OutLayout);
+		return;
+	}
+
+	TArray<FLineMetrics, TInlineAllocator<32>> Lines;
+	LayOutLines(GlyphTable, Params, Text, OutLayout, Lines);
+
+	const float TotalHeight = PlaceLines(Params, Lines);
+	OutLayout.TotalTextHeight = TotalHeight;
+	OutLayout.BuildPrefixSums();
+
+	// Fix-up: now that widths and the total height are known, move every line to its aligned origin.
+	const float BlockTop = GetAlignedBlockTop(Params.VerticalAlignment, TotalHeight);
+	FVector2f* Positions = OutLayout.CharacterPositions.GetData();
+	const int32* GlyphIndices = OutLayout.GlyphIndices.GetData();
+
+	for (int32 LineIdx = 0; LineIdx < Lines.Num(); ++LineIdx)
+	{
+		const FVector2f LineOrigin(GetAlignedLineStartX(Params.HorizontalAlignment, Lines[LineIdx].Width), Lines[LineIdx].Top + BlockTop);
+		const int32 Start = OutLayout.LineStartIndices[LineIdx];
+		const int32 End = Start + OutLayout.LineCharacterCounts[LineIdx];
+
+		for (int32 CharIdx = Start; CharIdx < End; ++CharIdx)
+		{
+			if (GlyphIndices[CharIdx] != INDEX_NONE)
+			{
+				Positions[CharIdx] += LineOrigin;
+			}
+		}
+	}
+}
+
+void FNTTTextLayoutEngine::BuildCounts(const FNTTLayoutParams& Params, FStringView Text, FNTTTextLayout& OutLayout)
+{
+	using namespace NTTTextLayoutPrivate;
+
+	SCOPE_CYCLE_COUNTER(STAT_NTT_Layout);
+	LLM_SCOPE_BYTAG(NTT);
+
+	ResetLayout(OutLayout);
+	OutLayout.bFilterWhitespaceCharactersValue = Params.bFilterWhitespaceCharacters;
+	OutLayout.WindowFirstLine = Params.WindowFirstLine;
+	OutLayout.DocumentLineCount = Params.DocumentLineCount;
+
+	const TCHAR* Chars = Text.GetData();
+	const int32 TextLength = Text.Len();
+	const bool bFilterWhitespace = Params.bFilterWhitespaceCharacters;
+
+	// Same walk as LayOutLines, counting the characters it would output instead of placing them
+	int32 NumOutput = 0;
+	bool bInsideWord = false;
+	int32 CurrentWordStartIndex = INDEX_NONE;
+	int32 CurrentWordCharCount = 0;
+
+	auto EndWord = [&]()
+	{
+		if (bInsideWord)
+		{
+			bInsideWord = false;
+			OutLayout.WordStartIndices.Add(CurrentWordStartIndex);
+			OutLayout.WordCharacterCounts.Add(CurrentWordCharCount);
+		}
+	};
+
+	// Empty text is a single empty line
+	int32 Index = 0;
+	do
+	{
+		const int32 LineStartIndex = NumOutput;
+
+		while (Index < TextLength && !IsNewlineChar(Chars[Index]))
+		{
+			const bool bIsWhitespace = IsWhitespaceChar(Chars[Index++]);
+
+			if (bIsWhitespace)
+			{
+				EndWord();
+			}
+			else
+			{
+				if (!bInsideWord)
+				{
+					bInsideWord = true;
+					CurrentWordStartIndex = NumOutput;
+					CurrentWordCharCount = 0;
+				}
+				CurrentWordCharCount++;
+			}
+
+			if (!(bFilterWhitespace && bIsWhitespace))
+			{
+				++NumOutput;
+			}
+		}
+
+		if (Index < TextLength)
+		{
+			if (Chars[Index] == '\r' && Index + 1 < TextLength && Chars[Index + 1] == '\n')
+			{
+				++Index;
+			}
+			++Index;
+		}
+
+		OutLayout.LineStartIndices.Add(LineStartIndex);
+		OutLayout.LineCharacterCounts.Add(NumOutput - LineStartIndex);
+
+		if (Index < TextLength)
+		{
+			EndWord();
+		}
+	}
+	while (Index < TextLength);
+
+	EndWord();
+	OutLayout.BuildPrefixSums();
+}
+
+void FNTTTextLayoutEngine::Combine(TConstArrayView<FNTTTextLayoutRef> Parts, FNTTTextLayout& OutLayout)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NTT_Layout);
+	LLM_SCOPE_BYTAG(NTT);
+
+	int32 TotalChars = 0;
+	int32 TotalLines = 0;
+	int32 TotalWords = 0;
+	for (const FNTTTextLayoutRef& Part : Parts)
+	{
+		TotalChars += Part->NumCharacters();
+		TotalLines += Part->NumLines();
+		TotalWords += Part->NumWords();
+	}
+
+	OutLayout = FNTTTextLayout();
+	OutLayout.GlyphIndices.Reserve(TotalChars);
+	OutLayout.CharacterPositions.Reserve(TotalChars);
+	OutLayout.CharacterLineIndices.Reserve(TotalChars);
+	OutLayout.CharacterWordIndices.Reserve(TotalChars);
+	OutLayout.CharacterEntryIndices.Reserve(TotalChars);
+	OutLayout.LineStartIndices.Reserve(TotalLines);
+	OutLayout.LineCharacterCounts.Reserve(TotalLines);
+	OutLayout.WordStartIndices.Reserve(TotalWords);
+	OutLayout.WordCharacterCounts.Reserve(TotalWords);
+	OutLayout.EntryStartIndices.Reserve(Parts.Num());
+	OutLayout.EntryCharacterCounts.Reserve(Parts.Num());
+
+	// Counts-only parts have no per-character data, so character indices are based on the line tables
+	int32 CharBase = 0;
+	for (int32 EntryIndex = 0; EntryIndex < Parts.Num(); ++EntryIndex)
+	{
+		const FNTTTextLayout& Part = *Parts[EntryIndex];
+		const int32 LineBase = OutLayout.NumLines();
+		const int32 WordBase = OutLayout.NumWords();
+		const int32 NumPartChars = Part.GetCharacterCount();
+
+		OutLayout.GlyphIndices.Append(Part.GlyphIndices);
+		OutLayout.CharacterPositions.Append(Part.CharacterPositions);
+		for (int32 CharIdx = 0; CharIdx < Part.NumCharacters(); ++CharIdx)
+		{
+			const int32 WordIndex = Part.CharacterWordIndices[CharIdx];
+			OutLayout.CharacterLineIndices.Add(Part.CharacterLineIndices[CharIdx] + LineBase);
+			OutLayout.CharacterWordIndices.Add(WordIndex >= 0 ? WordIndex + WordBase : INDEX_NONE);
+			OutLayout.CharacterEntryIndices.Add(EntryIndex);
+		}
+
+		for (int32 LineIdx = 0; LineIdx < Part.NumLines(); ++LineIdx)
+		{
+			OutLayout.LineStartIndices.Add(Part.LineStartIndices[LineIdx] + CharBase);
+			OutLayout.LineCharacterCounts.Add(Part.LineCharacterCounts[LineIdx]);
+		}
+
+		for (int32 WordIdx = 0; WordIdx < Part.NumWords(); ++WordIdx)
+		{
+			OutLayout.WordStartIndices.Add(Part.WordStartIndices[WordIdx] + CharBase);
+			OutLayout.WordCharacterCounts.Add(Part.WordCharacterCounts[WordIdx]);
+		}
+
+		OutLayout.EntryStartIndices.Add(CharBase);
+		OutLayout.EntryCharacterCounts.Add(NumPartChars);
+		OutLayout.TotalTextHeight = FMath::Max(OutLayout.TotalTextHeight, Part.TotalTextHeight);
+		OutLayout.bFilterWhitespaceCharactersValue = Part.bFilterWhitespaceCharactersValue;
+		CharBase += NumPartChars;
+	}
+
+	OutLayout.BuildPrefixSums();
+}
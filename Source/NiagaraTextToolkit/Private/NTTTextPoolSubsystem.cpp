@@ -0,0 +1,178 @@
+// Property of Lucian Tranc
+
+#include "NTTTextPoolSubsystem.h"
+#include "NiagaraTextToolkitHelpers.h"
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "NTTDataInterface.h"
+#include "Engine/World.h"
+
+static int32 GNTTTextPoolMaxFreePerSystem = 64;
+static FAutoConsoleVariableRef CVarNTTTextPoolMaxFreePerSystem(
+	TEXT("ntt.TextPool.MaxFreePerSystem"),
+	GNTTTextPoolMaxFreePerSystem,
+	TEXT("Maximum number of inactive components the NTT text pool keeps per Niagara system. Released components beyond this are destroyed."),
+	ECVF_Default);
+
+void UNTTTextPoolSubsystem::PrewarmPool(UNiagaraSystem* System, int32 Count)
+{
+	if (!System)
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT Text Pool: Cannot prewarm a null Niagara system"));
+		return;
+	}
+
+	// Keep what was asked for, or released components beyond ntt.TextPool.MaxFreePerSystem would be destroyed again
+	FNTTTextPool& Pool = Pools.FindOrAdd(System);
+	Pool.PrewarmedCount = FMath::Max(Pool.PrewarmedCount, Count);
+	const int32 NumToCreate = Count - Pool.FreeTexts.Num();
+	for (int32 i = 0; i < NumToCreate; ++i)
+	{
+		FNTTPooledText NewText;
+		if (!CreatePooledText(System, NewText))
+		{
+			return;
+		}
+		Pool.FreeTexts.Add(MoveTemp(NewText));
+	}
+}
+
+UNiagaraComponent* UNTTTextPoolSubsystem::SpawnText(UNiagaraSystem* System, const FString& Text, FVector Location, FRotator Rotation)
+{
+	if (!System)
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT Text Pool: Cannot spawn text for a null Niagara system"));
+		return nullptr;
+	}
+
+	FNTTPooledText PooledText;
+	if (FNTTTextPool* Pool = Pools.Find(System))
+	{
+		// Components can be destroyed behind our back, e.g. when the level they were registered with streams out
+		while (Pool->FreeTexts.Num() > 0 && !PooledText.Component)
+		{
+			PooledText = Pool->FreeTexts.Pop();
+			if (!IsValid(PooledText.Component) || !IsValid(PooledText.DataInterface))
+			{
+				PooledText = FNTTPooledText();
+			}
+		}
+	}
+
+	if (!PooledText.Component && !CreatePooledText(System, PooledText))
+	{
+		return nullptr;
+	}
+
+	UNiagaraComponent* Component = PooledText.Component;
+	PooledText.DataInterface->SetInputText(Text);
+	Component->SetWorldLocationAndRotation(Location, Rotation);
+	Component->Activate(true);
+
+	ActiveTexts.Add(Component, MoveTemp(PooledText));
+	return Component;
+}
+
+void UNTTTextPoolSubsystem::ReleaseText(UNiagaraComponent* Component)
+{
+	FNTTPooledText PooledText;
+	if (Component && ActiveTexts.RemoveAndCopyValue(Component, PooledText))
+	{
+		ReturnToPool(MoveTemp(PooledText));
+	}
+}
+
+int32 UNTTTextPoolSubsystem::GetNumFreeTexts(UNiagaraSystem* System) const
+{
+	const FNTTTextPool* Pool = Pools.Find(System);
+	return Pool ? Pool->FreeTexts.Num() : 0;
+}
+
+void UNTTTextPoolSubsystem::Deinitialize()
+{
+	for (TPair<TObjectPtr<UNiagaraSystem>, FNTTTextPool>& Pair : Pools)
+	{
+		for (FNTTPooledText& PooledText : Pair.Value.FreeTexts)
+		{
+			if (IsValid(PooledText.Component))
+			{
+				PooledText.Component->DestroyComponent();
+			}
+		}
+	}
+
+	for (TPair<TObjectPtr<UNiagaraComponent>, FNTTPooledText>& Pair : ActiveTexts)
+	{
+		if (IsValid(Pair.Value.Component))
+		{
+			Pair.Value.Component->OnSystemFinished.RemoveDynamic(this, &UNTTTextPoolSubsystem::OnPooledSystemFinished);
+			Pair.Value.Component->DestroyComponent();
+		}
+	}
+
+	Pools.Empty();
+	ActiveTexts.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNTTTextPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UNTTTextPoolSubsystem::CreatePooledText(UNiagaraSystem* System, FNTTPooledText& OutText)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	UNiagaraComponent* Component = NewObject<UNiagaraComponent>(World);
+	Component->SetAutoActivate(false);
+	Component->SetAutoDestroy(false);
+	Component->SetAsset(System);
+	Component->RegisterComponentWithWorld(World);
+
+	UNTTDataInterface* DataInterface = UNiagaraTextToolkitHelpers::FindNTTDataInterface(Component->GetOverrideParameters());
+	if (!DataInterface)
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("NTT Text Pool: Niagara system '%s' has no NTT user parameter"), *GetNameSafe(System));
+		Component->DestroyComponent();
+		return false;
+	}
+
+	Component->OnSystemFinished.AddUniqueDynamic(this, &UNTTTextPoolSubsystem::OnPooledSystemFinished);
+
+	OutText.Component = Component;
+	OutText.DataInterface = DataInterface;
+	OutText.System = System;
+	return true;
+}
+
+void UNTTTextPoolSubsystem::ReturnToPool(FNTTPooledText&& Text)
+{
+	if (!IsValid(Text.Component))
+	{
+		return;
+	}
+
+	// Removed from ActiveTexts before this point, so the OnSystemFinished fired by the deactivation is ignored
+	Text.Component->DeactivateImmediate();
+
+	FNTTTextPool& Pool = Pools.FindOrAdd(Text.System);
+	if (Pool.FreeTexts.Num() >= FMath::Max(GNTTTextPoolMaxFreePerSystem, Pool.PrewarmedCount))
+	{
+		Text.Component->OnSystemFinished.RemoveDynamic(this, &UNTTTextPoolSubsystem::OnPooledSystemFinished);
+		Text.Component->DestroyComponent();
+		return;
+	}
+
+	Pool.FreeTexts.Add(MoveTemp(Text));
+}
+
+void UNTTTextPoolSubsystem::OnPooledSystemFinished(UNiagaraComponent* Component)
+{
+	ReleaseText(Component);
+}
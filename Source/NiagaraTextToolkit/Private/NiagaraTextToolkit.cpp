@@ -3,6 +3,10 @@
 // NiagaraTextToolkit.cpp
 
 #include "NiagaraTextToolkit.h"
+#include "NTTDiagnostics.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTLayoutCache.h"
+#include "NTTDataInterface.h"
 #include "Modules/ModuleManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/Paths.h"
@@ -14,10 +18,18 @@ void FNiagaraTextToolkitModule::StartupModule()
 {
     FString PluginShaderDir = FPaths::Combine(IPluginManager::Get().FindPlugin(TEXT("NiagaraTextToolkit"))->GetBaseDir(), TEXT("Shaders"));
     AddShaderSourceDirectoryMapping(TEXT("/Plugin/NiagaraTextToolkit"), PluginShaderDir);
+
+    FNTTFontGlyphCache::Get().Initialize();
+    FNTTInstanceRemovalQueue::Get().Initialize();
+    FNTTInstanceRegistry::Get().Initialize();
 }
 
 void FNiagaraTextToolkitModule::ShutdownModule()
 {
+    FNTTInstanceRegistry::Get().Shutdown();
+    FNTTInstanceRemovalQueue::Get().Shutdown();
+    FNTTLayoutCache::Get().Empty();
+    FNTTFontGlyphCache::Get().Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -3,76 +3,101 @@
 #include "NiagaraTextToolkitHelpers.h"
 
 #include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
 #include "NiagaraTypes.h"
 #include "NiagaraUserRedirectionParameterStore.h"
 #include "NTTDataInterface.h"
+#include "NTTLayoutBatch.h"
 
-void UNiagaraTextToolkitHelpers::SetNiagaraNTTTextVariable(UNiagaraComponent* System, FString TextToDisplay)
+void UNiagaraTextToolkitHelpers::SetNiagaraNTTTextVariable(UNiagaraComponent* System, FString TextToDisplay, bool bResetSystem)
 {
 	UNTTDataInterface* FoundDI = FindNTTDataInterface(System);
 
 	if (FoundDI)
 	{
-		FoundDI->InputText = TextToDisplay;
+		FoundDI->SetInputText(TextToDisplay);
 
-		// Only reinitialize if the component is currently active
-		if (System && System->IsActive() && System->GetSystemInstanceController())
+		// Only reinitialize if requested and the component is currently active
+		if (bResetSystem && System && System->IsActive() && System->GetSystemInstanceController())
 		{
 			System->ReinitializeSystem();
 		}
 	}
 }
 
-void UNiagaraTextToolkitHelpers::SetNiagaraNTTFontVariable(UNiagaraComponent* System, UFont* Font)
+void UNiagaraTextToolkitHelpers::SetNiagaraNTTFontVariable(UNiagaraComponent* System, UFont* Font, bool bResetSystem)
 {
 	UNTTDataInterface* FoundDI = FindNTTDataInterface(System);
 
 	if (FoundDI)
 	{
-		FoundDI->FontAsset = Font;
+		FoundDI->SetFontAsset(Font);
 
-		// Only reinitialize if the component is currently active
-		if (System && System->IsActive() && System->GetSystemInstanceController())
+		// Only reinitialize if requested and the component is currently active
+		if (bResetSystem && System && System->IsActive() && System->GetSystemInstanceController())
 		{
 			System->ReinitializeSystem();
 		}
 	}
 }
 
-UNTTDataInterface* UNiagaraTextToolkitHelpers::FindNTTDataInterface(UNiagaraComponent* System)
+FNTTTextEntryHandle UNiagaraTextToolkitHelpers::AddNiagaraNTTTextEntry(UNiagaraComponent* System, FString Text, FVector Origin, float Lifetime)
+{
+	UNTTDataInterface* FoundDI = FindNTTDataInterface(System);
+
+	if (FoundDI)
+	{
+		return FoundDI->AddTextEntry(Text, Origin, Lifetime);
+	}
+
+	return FNTTTextEntryHandle();
+}
+
+bool UNiagaraTextToolkitHelpers::RemoveNiagaraNTTTextEntry(UNiagaraComponent* System, FNTTTextEntryHandle Handle)
+{
+	UNTTDataInterface* FoundDI = FindNTTDataInterface(System);
+
+	return FoundDI && FoundDI->RemoveTextEntry(Handle);
+}
+
+int32 UNiagaraTextToolkitHelpers::PrewarmNTTTextLayouts(UNiagaraSystem* System, const TArray<FString>& Texts)
 {
 	if (!System)
 	{
-		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("FontFXHelpers: Niagara component is null"));
-		return nullptr;
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("FontFXHelpers: Niagara system is null"));
+		return 0;
+	}
+
+	UNTTDataInterface* FoundDI = FindNTTDataInterface(System->GetExposedParameters());
+	if (!FoundDI)
+	{
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("FontFXHelpers: No UNTTDataInterface user variable found on system '%s'"), *GetNameSafe(System));
+		return 0;
 	}
 
-	UNTTDataInterface* FoundDI = nullptr;
+	const FNTTLayoutParams BaseParams = FoundDI->GetLayoutParams();
 
-	FNiagaraUserRedirectionParameterStore& Overrides = System->GetOverrideParameters();
-	TArray<FNiagaraVariable> OutParameters;
+	TArray<FNTTLayoutParams> Requests;
+	Requests.Reserve(Texts.Num());
+	for (const FString& Text : Texts)
+	{
+		FNTTLayoutParams& Request = Requests.Add_GetRef(BaseParams);
+		Request.InputText = Text;
+	}
 
-	Overrides.GetUserParameters(OutParameters);
+	FNTTLayoutBatch::Prewarm(Requests);
+	return Requests.Num();
+}
 
-	const int32 NumParams = OutParameters.Num();
-	for (int32 i = 0; i < NumParams; ++i)
+UNTTDataInterface* UNiagaraTextToolkitHelpers::FindNTTDataInterface(UNiagaraComponent* System)
+{
+	if (!System)
 	{
-		const FNiagaraVariable& Var = OutParameters[i];
-		if (Var.GetType() == FNiagaraTypeDefinition(UNTTDataInterface::StaticClass()))
-		{
-			if (UNiagaraDataInterface* DI = Overrides.GetDataInterface(Var))
-			{
-				FoundDI = Cast<UNTTDataInterface>(DI);
-				if (FoundDI)
-				{
-					UE_LOG(LogNiagaraTextToolkit, Log, TEXT("FontFXHelpers: Found NTT DI on component overrides: %s (Param: %s)"),
-						*GetNameSafe(FoundDI), *Var.GetName().ToString());
-					break;
-				}
-			}
-		}
+		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("FontFXHelpers: Niagara component is null"));
+		return nullptr;
 	}
 
+	UNTTDataInterface* FoundDI = FindNTTDataInterface(System->GetOverrideParameters());
 	if (!FoundDI)
 	{
 		UE_LOG(LogNiagaraTextToolkit, Warning, TEXT("FontFXHelpers: No UNTTDataInterface user variable found on component or system"));
@@ -80,4 +105,20 @@ UNTTDataInterface* UNiagaraTextToolkitHelpers::FindNTTDataInterface(UNiagaraComp
 	}
 
 	return FoundDI;
-}
\ No newline at end of file
+}
+
+UNTTDataInterface* UNiagaraTextToolkitHelpers::FindNTTDataInterface(FNiagaraUserRedirectionParameterStore& Parameters)
+{
+	// Every data interface in the store lives in its DataInterfaces array, so scan that directly
+	// instead of copying all user variables out and looking each one up
+	for (UNiagaraDataInterface* DI : Parameters.GetDataInterfaces())
+	{
+		if (UNTTDataInterface* FoundDI = Cast<UNTTDataInterface>(DI))
+		{
+			UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("FontFXHelpers: Found NTT DI in user parameters: %s"), *GetNameSafe(FoundDI));
+			return FoundDI;
+		}
+	}
+
+	return nullptr;
+}
@@ -4,7 +4,16 @@
 
 #include "NiagaraDataInterface.h"
 #include "VectorVM.h"
+#include "RenderResource.h"
+#include "RenderGraphBuilder.h"
+#include "Misc/StringBuilder.h"
+#include "Tasks/Task.h"
 #include "Engine/Font.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTLayoutCache.h"
+#include "NTTPackedEncoding.h"
+#include "NTTStats.h"
+#include "NTTTextLayout.h"
 #include "NTTDataInterface.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogNiagaraTextToolkit, Log, All);
@@ -30,155 +39,671 @@ enum class ENTTTextHorizontalAlignment : uint8
 	NTT_THA_Right	UMETA(DisplayName = "Right"),
 };
 
+// Formatting of the value shown by the data interface in numeric mode
+USTRUCT(BlueprintType)
+struct NIAGARATEXTTOOLKIT_API FNTTNumericFormat
+{
+	GENERATED_BODY()
+
+	// Number of digits after the decimal point
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", ClampMax = "9"))
+	int32 Decimals = 0;
+
+	// Separates every three integer digits with a comma (12,345)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bDigitGrouping = false;
+
+	// Shows a '+' in front of positive values
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bAlwaysShowSign = false;
+
+	// Text placed before the number, e.g. "x" or "$"
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString Prefix;
+
+	// Text placed after the number, e.g. "%" or " XP"
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString Suffix;
+
+	// Appends Prefix, Value and Suffix to Out. Never allocates as long as Out's inline storage is large enough.
+	void Append(FStringBuilderBase& Out, double Value) const;
+
+	bool operator==(const FNTTNumericFormat& Other) const
+	{
+		return Decimals == Other.Decimals
+			&& bDigitGrouping == Other.bDigitGrouping
+			&& bAlwaysShowSign == Other.bAlwaysShowSign
+			&& Prefix == Other.Prefix
+			&& Suffix == Other.Suffix;
+	}
+};
+
+// Identifies a text entry of a data interface in multi-text mode. Stays invalid once its entry has been removed.
+USTRUCT(BlueprintType)
+struct FNTTTextEntryHandle
+{
+	GENERATED_BODY()
+
+	int32 Index = INDEX_NONE;
+	int32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+// Stack buffer numeric mode formats into
+typedef TStringBuilder<64> FNTTNumericTextBuilder;
+
+// Snapshot of the data interface properties that affect text layout
+struct FNTTLayoutParams
+{
+	const UFont* FontAsset = nullptr;
+	FString InputText;
+	ENTTTextHorizontalAlignment HorizontalAlignment = ENTTTextHorizontalAlignment::NTT_THA_Center;
+	ENTTTextVerticalAlignment VerticalAlignment = ENTTTextVerticalAlignment::NTT_TVA_Center;
+	float VerticalOffset = 0.0f;
+	float KerningOffset = 0.0f;
+	float WhitespaceWidthMultiplier = 1.0f;
+	bool bFilterWhitespaceCharacters = true;
+	// Set when the text is a numeric value that was formatted into the caller's buffer instead of InputText
+	bool bNumericText = false;
+	// Set in multi-text mode, where the text comes from the data interface's text entries instead of InputText
+	bool bMultiText = false;
+	// Set in streaming mode. The text then only holds the lines of the current window.
+	bool bStreaming = false;
+	// Set in streaming mode when the window was copied into the caller's buffer instead of InputText
+	bool bWindowText = false;
+	// Streaming mode: document line the window starts at, and line count of the whole document
+	int32 WindowFirstLine = 0;
+	int32 DocumentLineCount = 0;
+	// UNTTDataInterface::ParameterRevision these values were read at
+	uint32 Revision = 0;
+};
+
 // The struct used to store our data interface data
 struct FNDIFontUVInfoInstanceData
 {
-	// Normalized per-glyph UVs in texture space: (USize, VSize, UStart, VStart), all in 0-1
-	TArray<FVector4> CharacterTextureUvs;
-	// Per-glyph sprite size in pixels: (Width, Height)
-	TArray<FVector2f> CharacterSpriteSizes;
-	TArray<int32> Unicode;
-	TArray<FVector2f> CharacterPositions;
-	TArray<int32> LineStartIndices;
-	TArray<int32> LineCharacterCounts;
-	TArray<int32> WordStartIndices;
-	TArray<int32> WordCharacterCounts;
-	float TotalTextHeight = 0.0f;
-	bool bFilterWhitespaceCharactersValue = true;
+	// Shared per-font glyph UVs, sprite sizes and vertical offsets (see FNTTFontGlyphCache)
+	FNTTGlyphTableRef GlyphTable;
+	// Layout of the current text. Replaced when the text changes; only rebuilt in place while nothing else references it.
+	FNTTTextLayoutRef Layout;
+	// Bumped every time GlyphTable or Layout is replaced
+	uint32 LayoutVersion = 0;
+	// Last LayoutVersion handed to the render thread
+	uint32 LastSentLayoutVersion = 0;
+	// UNTTDataInterface::ParameterRevision the current layout was built from
+	uint32 ParameterRevision = 0;
+	// Multi-text mode: origin and times of every entry in Layout, null otherwise. Replaced on its own when entries only move.
+	FNTTEntryPlacementsRef EntryPlacements;
+	// Bumped every time EntryPlacements is replaced
+	uint32 EntryPlacementsVersion = 0;
+	// Last EntryPlacementsVersion handed to the render thread
+	uint32 LastSentEntryPlacementsVersion = 0;
+	// Multi-text mode: seconds since EntryPlacements->EntryClockBase, updated every tick
+	float EntryClock = 0.0f;
+	// Index of this instance's render thread data in the proxy (see FNDIFontUVInfoProxy::AllocateSlot_GT)
+	int32 Slot = INDEX_NONE;
+	// Layout being built on a worker (see ntt.AsyncLayoutThreshold). PerInstanceTick swaps it in once it completes.
+	UE::Tasks::TTask<FNTTTextLayoutRef> PendingLayoutTask;
+	FNTTGlyphTableRef PendingGlyphTable;
+	// Nothing this instance shows can be seen (see ntt.MinimalMode): no font, no positions and nothing sent to the render thread
+	bool bMinimal = false;
+	// Numeric and streaming modes: previous layouts, rebuilt in place once the render thread has let go of them
+	// (see ClaimReusableLayout)
+	TArray<FNTTTextLayoutRef, TInlineAllocator<2>> RetiredLayouts;
+	// Streaming mode: lines of the current window, copied out of the document under the lock. Reused between scrolls.
+	FString StreamingWindowText;
+	// Multi-text mode: layout of every entry Layout was combined from, in order. When they are unchanged an update only
+	// replaces EntryPlacements.
+	TArray<FNTTTextLayoutRef> EntryLayouts;
+
+	// The render thread keeps the last layout it received until the next one arrives, and a frame can be in flight,
+	// so rotating through the current layout and two retired ones is enough for updates every frame.
+	static constexpr int32 MaxRetiredLayouts = 2;
+
+	bool IsLayoutReady() const { return !PendingLayoutTask.IsValid(); }
+
+	// Returns a layout nothing else references, to be rebuilt in place and passed to SetLayout: the current layout if it is
+	// unique, otherwise a retired one, or a new one only when every layout is still in use. The current layout is retired.
+	TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> ClaimReusableLayout()
+	{
+		if (Layout.IsUnique())
+		{
+			return ConstCastSharedPtr<FNTTTextLayout>(Layout);
+		}
+
+		TSharedPtr<FNTTTextLayout, ESPMode::ThreadSafe> Reusable;
+		for (int32 Index = 0; Index < RetiredLayouts.Num(); ++Index)
+		{
+			if (RetiredLayouts[Index].IsUnique())
+			{
+				Reusable = ConstCastSharedPtr<FNTTTextLayout>(RetiredLayouts[Index]);
+				RetiredLayouts.RemoveAtSwap(Index, 1, false);
+				break;
+			}
+		}
+
+		if (Layout.IsValid())
+		{
+			if (RetiredLayouts.Num() == MaxRetiredLayouts)
+			{
+				RetiredLayouts.RemoveAt(0, 1, false);
+			}
+			RetiredLayouts.Add(Layout);
+		}
+
+		if (!Reusable.IsValid())
+		{
+			NTTStats::OnInPlaceLayoutAllocated();
+			Reusable = MakeShared<FNTTTextLayout, ESPMode::ThreadSafe>();
+		}
+		return Reusable;
+	}
+
+	SIZE_T GetRetiredLayoutBytes() const
+	{
+		SIZE_T Bytes = RetiredLayouts.GetAllocatedSize();
+		for (const FNTTTextLayoutRef& Retired : RetiredLayouts)
+		{
+			Bytes += sizeof(FNTTTextLayout) + Retired->GetAllocatedSize();
+		}
+		return Bytes;
+	}
+
+	void SetLayout(FNTTGlyphTableRef InGlyphTable, FNTTTextLayoutRef InLayout)
+	{
+		GlyphTable = MoveTemp(InGlyphTable);
+		Layout = MoveTemp(InLayout);
+		++LayoutVersion;
+	}
+
+	void SetEntryPlacements(FNTTEntryPlacementsRef InEntryPlacements)
+	{
+		if (EntryPlacements.IsValid() || InEntryPlacements.IsValid())
+		{
+			EntryPlacements = MoveTemp(InEntryPlacements);
+			++EntryPlacementsVersion;
+		}
+	}
+};
+
+// Data passed from the game thread to the render thread every frame.
+// Only carries the shared layout when it changed since the last frame; otherwise it is empty and nothing is uploaded.
+struct FNDIFontUVInfoRenderThreadData
+{
+	FNTTGlyphTableRef GlyphTable;
+	FNTTTextLayoutRef Layout;
+	uint32 LayoutVersion = 0;
+	bool bLayoutChanged = false;
+	// Only set when the entry placements changed, which can happen without the layout changing
+	FNTTEntryPlacementsRef EntryPlacements;
+	bool bEntryPlacementsChanged = false;
+	// Sent every frame, entry ages are computed from it
+	float EntryClock = 0.0f;
+	int32 Slot = INDEX_NONE;
+	bool bLayoutReady = true;
+};
+
+// GPU copy of a glyph table. One buffer exists per font and is shared by every instance of every NTT DI on the render thread.
+struct FNTTGlyphBuffer
+{
+	FRWBufferStructured Buffer;
+	uint32 TableId = 0;
+	uint32 NumRects = 0;
+	// UVs as unorm16 and sizes as half2 (see NTTPackedEncoding::ShouldUseCompactGlyphs)
+	bool bCompact = false;
+
+	// Offsets (in floats) into Buffer
+	uint32 Offset_UVs = 0;
+	uint32 Offset_Sizes = 0;
+
+	~FNTTGlyphBuffer()
+	{
+		DEC_MEMORY_STAT_BY(STAT_NTT_GlyphBufferMemory, Buffer.NumBytes);
+		Buffer.Release();
+	}
+};
+
+// Render thread only, so the reference count doesn't need to be thread safe.
+typedef TSharedPtr<FNTTGlyphBuffer> FNTTGlyphBufferRef;
+
+// Render thread registry of shared glyph buffers, keyed by FNTTGlyphTable::TableId.
+// Buffers are released once the last instance referencing them is released.
+struct FNTTGlyphBufferRegistry
+{
+	static FNTTGlyphBufferRef FindOrCreate_RT(const FNTTGlyphTable& GlyphTable, FRHICommandListBase& RHICmdList);
+};
+
+// Render thread pool of per-instance text buffers. Buffers are bucketed by element size and power-of-two element count,
+// so text changes and short-lived instances reuse buffers instead of creating and destroying RHI resources.
+// Idle buffers are capped by ntt.BufferPool.MaxBytes.
+class FNTTBufferPool : public FRenderResource
+{
+public:
+	typedef TUniquePtr<FRWBufferStructured> FBufferPtr;
+
+	// Returns a buffer with room for at least NumElements elements of BytesPerElement bytes
+	FBufferPtr Acquire_RT(FRHICommandListBase& RHICmdList, const TCHAR* DebugName, uint32 BytesPerElement, uint32 NumElements);
+
+	// Returns Buffer to the pool, or releases it when the pool is full. Buffer is null afterwards.
+	void Release_RT(FBufferPtr& Buffer);
+
+	// Bytes held by idle buffers waiting for reuse
+	uint64 GetFreeBytes_RT() const { return FreeBytes; }
+
+	virtual void ReleaseRHI() override;
+
+private:
+	TMap<uint64, TArray<FBufferPtr>> FreeBuffers;
+	uint64 FreeBytes = 0;
+};
+
+extern TGlobalResource<FNTTBufferPool> GNTTBufferPool;
+
+// Placeholder buffers bound when an instance has no data yet. Created once with the RHI and shared by every proxy.
+class FNTTDefaultBuffers : public FRenderResource
+{
+public:
+	// Bound to GlyphBuffer, TextBuffer and EntryBuffer
+	FRWBufferStructured FloatBuffer;
+	// Bound to CharRecordBuffer
+	FRWBufferStructured RecordBuffer;
+
+	virtual void InitRHI(FRHICommandListBase& RHICmdList) override;
+	virtual void ReleaseRHI() override;
+};
+
+extern TGlobalResource<FNTTDefaultBuffers> GNTTDefaultBuffers;
+
+struct FNDIFontUVInfoProxy;
+
+// Collects render thread instance removals from every NTT DI and sends them in one render command at the end of the frame.
+// Slots only become reusable once their removal has been sent, so a slot is never live for two instances on the render thread.
+// Exported so tests that tick a world without the engine loop can flush it at the end of their frames.
+class NIAGARATEXTTOOLKIT_API FNTTInstanceRemovalQueue
+{
+public:
+	static FNTTInstanceRemovalQueue& Get();
+
+	// Hooks the end of frame flush, called by the module
+	void Initialize();
+	void Shutdown();
+
+	void Enqueue(FNDIFontUVInfoProxy* Proxy, FNiagaraSystemInstanceID InstanceID, int32 Slot);
+
+	// Sends everything queued so far. Also called before a DI's proxy is destroyed.
+	void Flush();
+
+private:
+	struct FRemoval
+	{
+		FNDIFontUVInfoProxy* Proxy = nullptr;
+		FNiagaraSystemInstanceID InstanceID = 0;
+		int32 Slot = INDEX_NONE;
+	};
+
+	FCriticalSection Lock;
+	TArray<FRemoval> Pending;
+	FDelegateHandle EndFrameHandle;
 };
 
 // This proxy is used to safely copy data between game thread and render thread
 struct FNDIFontUVInfoProxy : public FNiagaraDataInterfaceProxy
 {
-	// We manage render-thread buffers explicitly via InitPerInstanceData/UpdateData_RT,
-	// so we don't need Niagara's per-frame GT->RT instance data path.
-	virtual int32 PerInstanceDataPassedToRenderThreadSize() const override { return sizeof(FNDIFontUVInfoInstanceData); }
+	// Niagara calls ProvidePerInstanceDataForRenderThread every frame, so the payload is kept small
+	// and only references the layout when its version changed (see FNDIFontUVInfoRenderThreadData).
+	virtual int32 PerInstanceDataPassedToRenderThreadSize() const override { return sizeof(FNDIFontUVInfoRenderThreadData); }
 
 	virtual ~FNDIFontUVInfoProxy() override
 	{
-		PackedBuffer.Release();
+		for (FRTInstanceData& RTInstance : InstanceSlots_RT)
+		{
+			RTInstance.Reset();
+		}
 	}
 
-	FRWBufferStructured PackedBuffer;
-	bool bDefaultInitialized = false;
-
 	struct FRTInstanceData
 	{
-		FRWBufferStructured PackedBuffer;
-		uint32 NumRects = 0;
+		FNiagaraSystemInstanceID InstanceID = 0;
+		bool bInUse = false;
+		// Shared per-font glyph UVs and sizes
+		FNTTGlyphBufferRef GlyphBuffer;
+		// Per-instance glyph index, position, line and word arrays, from GNTTBufferPool
+		FNTTBufferPool::FBufferPtr TextBuffer;
+		// One uint4 per character (see NTTPackedEncoding::BuildCharacterRecords). When valid, TextBuffer holds no per-character arrays.
+		FNTTBufferPool::FBufferPtr CharRecordBuffer;
+		bool bHasCharRecords = false;
+		// Multi-text entry origins and times, from GNTTBufferPool. Uploaded on their own, so moving an entry doesn't touch TextBuffer.
+		FNTTBufferPool::FBufferPtr EntryBuffer;
+		// Layout received from the game thread that hasn't been uploaded yet. Uploads happen in PreStage with
+		// the stage's command list, so instances that never run a GPU stage never create buffers.
+		FNTTGlyphTableRef PendingGlyphTable;
+		FNTTTextLayoutRef PendingLayout;
+		uint32 PendingLayoutVersion = 0;
+		bool bUploadPending = false;
+		FNTTEntryPlacementsRef PendingEntryPlacements;
+		bool bEntryUploadPending = false;
 		uint32 NumChars = 0;
 		uint32 NumLines = 0;
 		uint32 NumWords = 0;
+		uint32 NumEntries = 0;
 		uint32 bFilterWhitespaceCharactersValue = 1;
 		float TotalTextHeight = 0.0f;
+		float EntryClock = 0.0f;
+		uint32 bLayoutReady = 0;
+		int32 WindowFirstLine = 0;
+		int32 DocumentLineCount = 0;
+		// Version of the layout currently uploaded to TextBuffer
+		uint32 LayoutVersion = 0;
+		// ENTTTextEncoding flags TextBuffer was written with
+		uint32 TextEncoding = 0;
 		
-		uint32 Offset_UVs = 0;
-		uint32 Offset_Sizes = 0;
-		uint32 Offset_Unicode = 0;
+		uint32 Offset_GlyphIndices = 0;
 		uint32 Offset_Positions = 0;
+		uint32 Offset_CharLine = 0;
+		uint32 Offset_CharWord = 0;
 		uint32 Offset_LineStart = 0;
 		uint32 Offset_LineCount = 0;
 		uint32 Offset_WordStart = 0;
 		uint32 Offset_WordCount = 0;
-
+		uint32 Offset_WordPrefix = 0;
+		uint32 Offset_WordTrailingPrefix = 0;
+		uint32 Offset_LinePrefix = 0;
+		uint32 Offset_CharEntry = 0;
+		uint32 Offset_EntryStart = 0;
+		uint32 Offset_EntryCount = 0;
+		// Offsets into EntryBuffer
+		uint32 Offset_EntryOrigin = 0;
+		uint32 Offset_EntryTime = 0;
+
+		// Releases the uploaded layout. Entry placements and pending uploads are kept.
 		void Release()
 		{
-			PackedBuffer.Release();
-			NumRects = 0;
+			GlyphBuffer.Reset();
+			GNTTBufferPool.Release_RT(TextBuffer);
+			GNTTBufferPool.Release_RT(CharRecordBuffer);
+			bHasCharRecords = false;
 			NumChars = 0;
 			NumLines = 0;
 			NumWords = 0;
+			NumEntries = 0;
 			bFilterWhitespaceCharactersValue = 1;
 			TotalTextHeight = 0.0f;
+			WindowFirstLine = 0;
+			DocumentLineCount = 0;
+			LayoutVersion = 0;
+			TextEncoding = 0;
 		
-			Offset_UVs = 0;
-			Offset_Sizes = 0;
-			Offset_Unicode = 0;
+			Offset_GlyphIndices = 0;
 			Offset_Positions = 0;
+			Offset_CharLine = 0;
+			Offset_CharWord = 0;
 			Offset_LineStart = 0;
 			Offset_LineCount = 0;
 			Offset_WordStart = 0;
 			Offset_WordCount = 0;
+			Offset_WordPrefix = 0;
+			Offset_WordTrailingPrefix = 0;
+			Offset_LinePrefix = 0;
+			Offset_CharEntry = 0;
+			Offset_EntryStart = 0;
+			Offset_EntryCount = 0;
+		}
+
+		// Releases the uploaded entry placements
+		void ReleaseEntryPlacements()
+		{
+			GNTTBufferPool.Release_RT(EntryBuffer);
+			Offset_EntryOrigin = 0;
+			Offset_EntryTime = 0;
+		}
+
+		// Releases everything and frees the slot
+		void Reset()
+		{
+			Release();
+			ReleaseEntryPlacements();
+			PendingGlyphTable.Reset();
+			PendingLayout.Reset();
+			PendingLayoutVersion = 0;
+			bUploadPending = false;
+			PendingEntryPlacements.Reset();
+			bEntryUploadPending = false;
+			EntryClock = 0.0f;
+			bLayoutReady = 0;
+			InstanceID = 0;
+			bInUse = false;
 		}
 	};
 
-	void EnsureDefaultBuffer(FRHICommandListBase& RHICmdList)
+	// Returns a free slot for a new instance. Game thread side, slots of removed instances come back through FNTTInstanceRemovalQueue.
+	int32 AllocateSlot_GT()
+	{
+		FScopeLock ScopeLock(&SlotLock_GT);
+		return (FreeSlots_GT.Num() > 0) ? FreeSlots_GT.Pop() : NumSlots_GT++;
+	}
+
+	void FreeSlot_GT(int32 Slot)
+	{
+		FScopeLock ScopeLock(&SlotLock_GT);
+		FreeSlots_GT.Add(Slot);
+	}
+
+	// Returns the data in Slot, claiming the slot for InstanceID if it isn't already
+	FRTInstanceData& AddInstance_RT(FNiagaraSystemInstanceID InstanceID, int32 Slot)
+	{
+		if (Slot >= InstanceSlots_RT.Num())
+		{
+			InstanceSlots_RT.SetNum(Slot + 1);
+		}
+
+		FRTInstanceData& RTInstance = InstanceSlots_RT[Slot];
+		if (!RTInstance.bInUse || RTInstance.InstanceID != InstanceID)
+		{
+			if (RTInstance.bInUse)
+			{
+				RemoveInstance_RT(RTInstance.InstanceID, Slot);
+			}
+			RTInstance.InstanceID = InstanceID;
+			RTInstance.bInUse = true;
+			AddToSlotTable_RT(Slot);
+		}
+		return RTInstance;
+	}
+
+	// Lookup by instance ID for the compute callbacks, which only get the ID. Resolves to a slot through SlotTable_RT,
+	// usually with a single array read, and never hashes or allocates.
+	FRTInstanceData* FindInstance_RT(FNiagaraSystemInstanceID InstanceID)
+	{
+		if (SlotTable_RT.Num() == 0)
+		{
+			return nullptr;
+		}
+
+		const uint32 Mask = SlotTable_RT.Num() - 1;
+		for (uint32 Bucket = GetSlotTableBucket(InstanceID, Mask); SlotTable_RT[Bucket] != INDEX_NONE; Bucket = (Bucket + 1) & Mask)
+		{
+			FRTInstanceData& RTInstance = InstanceSlots_RT[SlotTable_RT[Bucket]];
+			if (RTInstance.InstanceID == InstanceID)
+			{
+				return &RTInstance;
+			}
+		}
+		return nullptr;
+	}
+
+	void RemoveInstance_RT(FNiagaraSystemInstanceID InstanceID, int32 Slot)
 	{
-		if (!bDefaultInitialized)
+		if (!InstanceSlots_RT.IsValidIndex(Slot) || !InstanceSlots_RT[Slot].bInUse || InstanceSlots_RT[Slot].InstanceID != InstanceID)
 		{
-			PackedBuffer.Initialize(RHICmdList, TEXT("NTT_Packed_Default"), sizeof(float), 4, BUF_ShaderResource | BUF_Static);
-			float Zeros[4] = { 0, 0, 0, 0 };
-			void* Dest = RHICmdList.LockBuffer(PackedBuffer.Buffer, 0, sizeof(float) * 4, RLM_WriteOnly);
-			FMemory::Memcpy(Dest, &Zeros, sizeof(float) * 4);
-			RHICmdList.UnlockBuffer(PackedBuffer.Buffer);
-			bDefaultInitialized = true;
+			return;
+		}
+
+		// The table reads instance IDs from the slots, so take the slot out before resetting it
+		RemoveFromSlotTable_RT(Slot);
+		InstanceSlots_RT[Slot].Reset();
+	}
+
+	// GPU memory held by an instance, for the diagnostics commands. The glyph buffer is shared by every instance using the font.
+	void GetInstanceGPUBytes_RT(FNiagaraSystemInstanceID InstanceID, SIZE_T& OutTextBytes, SIZE_T& OutGlyphBytes)
+	{
+		OutTextBytes = 0;
+		OutGlyphBytes = 0;
+		if (const FRTInstanceData* RTInstance = FindInstance_RT(InstanceID))
+		{
+			OutTextBytes += RTInstance->TextBuffer.IsValid() ? RTInstance->TextBuffer->NumBytes : 0;
+			OutTextBytes += RTInstance->CharRecordBuffer.IsValid() ? RTInstance->CharRecordBuffer->NumBytes : 0;
+			OutTextBytes += RTInstance->EntryBuffer.IsValid() ? RTInstance->EntryBuffer->NumBytes : 0;
+			OutGlyphBytes = RTInstance->GlyphBuffer.IsValid() ? RTInstance->GlyphBuffer->Buffer.NumBytes : 0;
 		}
 	}
 
 	static void ProvidePerInstanceDataForRenderThread(void* InDataForRenderThread, void* InDataFromGameThread, const FNiagaraSystemInstanceID& SystemInstance)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_NTT_ProvideRenderThreadData);
+
 		// Initialize the render thread instance data into the pre-allocated memory
-		FNDIFontUVInfoInstanceData* DataForRenderThread = new (InDataForRenderThread) FNDIFontUVInfoInstanceData();
+		FNDIFontUVInfoRenderThreadData* DataForRenderThread = new (InDataForRenderThread) FNDIFontUVInfoRenderThreadData();
+
+		// Minimal instances have no slot and never reach the render thread
+		FNDIFontUVInfoInstanceData* DataFromGameThread = static_cast<FNDIFontUVInfoInstanceData*>(InDataFromGameThread);
+		if (DataFromGameThread->bMinimal)
+		{
+			return;
+		}
 
-		// Copy the game thread data
-		const FNDIFontUVInfoInstanceData* DataFromGameThread = static_cast<const FNDIFontUVInfoInstanceData*>(InDataFromGameThread);
-		*DataForRenderThread = *DataFromGameThread;
+		// Only hand over the layout if it changed since the last frame. This just adds references, the arrays are never copied.
+		DataForRenderThread->EntryClock = DataFromGameThread->EntryClock;
+		DataForRenderThread->Slot = DataFromGameThread->Slot;
+		DataForRenderThread->bLayoutReady = DataFromGameThread->IsLayoutReady();
+		if (DataFromGameThread->LayoutVersion != DataFromGameThread->LastSentLayoutVersion)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(NTT_SendLayout, NTTChannel);
 
-		UE_LOG(LogNiagaraTextToolkit, Verbose, TEXT("NTT DI (RT): ProvidePerInstanceDataForRenderThread - InstanceID=%llu, CharacterTextureUvs.Num=%d"),
-			(uint64)SystemInstance, DataForRenderThread->CharacterTextureUvs.Num());
+			DataForRenderThread->GlyphTable = DataFromGameThread->GlyphTable;
+			DataForRenderThread->Layout = DataFromGameThread->Layout;
+			DataForRenderThread->LayoutVersion = DataFromGameThread->LayoutVersion;
+			DataForRenderThread->bLayoutChanged = true;
+			DataFromGameThread->LastSentLayoutVersion = DataFromGameThread->LayoutVersion;
+		}
+		if (DataFromGameThread->EntryPlacementsVersion != DataFromGameThread->LastSentEntryPlacementsVersion)
+		{
+			DataForRenderThread->EntryPlacements = DataFromGameThread->EntryPlacements;
+			DataForRenderThread->bEntryPlacementsChanged = true;
+			DataFromGameThread->LastSentEntryPlacementsVersion = DataFromGameThread->EntryPlacementsVersion;
+		}
 	}
 
-	void UpdateData_RT(FNDIFontUVInfoInstanceData* InstanceDataFromGT, const FNiagaraSystemInstanceID& InstanceID, FRHICommandListBase& RHICmdList)
+	// Uploads the instance's pending layout
+	void UpdateData_RT(FRTInstanceData& RTInstance, FRHICommandListBase& RHICmdList)
 	{
-		FRTInstanceData& RTInstance = SystemInstancesToInstanceData_RT.FindOrAdd(InstanceID);
+		SCOPE_CYCLE_COUNTER(STAT_NTT_BufferUpload);
+		CSV_SCOPED_TIMING_STAT(NTT, BufferUpload);
+		LLM_SCOPE_BYTAG(NTT_GPUBuffers);
+		INC_DWORD_STAT(STAT_NTT_BufferUploads);
+
+		const FNTTGlyphTableRef GlyphTable = MoveTemp(RTInstance.PendingGlyphTable);
+		const FNTTTextLayoutRef LayoutRef = MoveTemp(RTInstance.PendingLayout);
+		RTInstance.bUploadPending = false;
 
-		// Release old data first. This resets all counts and offsets to 0.
+		// Release old data first. This resets all counts and offsets to 0 and returns the buffers to the pool.
 		RTInstance.Release();
+		RTInstance.LayoutVersion = RTInstance.PendingLayoutVersion;
+
+		// The glyph table is uploaded once per font and shared with every other instance using it.
+		if (GlyphTable.IsValid() && GlyphTable->IsValid())
+		{
+			RTInstance.GlyphBuffer = FNTTGlyphBufferRegistry::FindOrCreate_RT(*GlyphTable, RHICmdList);
+		}
+
+		static const FNTTTextLayout EmptyLayout;
+		const FNTTTextLayout& Layout = LayoutRef.IsValid() ? *LayoutRef : EmptyLayout;
 
 		// Calculate sizes
-		const int32 NumRects = InstanceDataFromGT->CharacterTextureUvs.Num();
-		const int32 NumChars = InstanceDataFromGT->Unicode.Num();
-		const int32 NumLines = InstanceDataFromGT->LineStartIndices.Num();
-		const int32 NumWords = InstanceDataFromGT->WordStartIndices.Num();
+		const int32 NumChars = Layout.NumCharacters();
+		const int32 NumLines = Layout.LineStartIndices.Num();
+		const int32 NumWords = Layout.WordStartIndices.Num();
+		const int32 NumEntries = Layout.NumEntries();
 
-		RTInstance.NumRects = (uint32)NumRects;
 		RTInstance.NumChars = (uint32)NumChars;
 		RTInstance.NumLines = (uint32)NumLines;
 		RTInstance.NumWords = (uint32)NumWords;
-		RTInstance.bFilterWhitespaceCharactersValue = InstanceDataFromGT->bFilterWhitespaceCharactersValue ? 1u : 0u;
-		RTInstance.TotalTextHeight = InstanceDataFromGT->TotalTextHeight;
+		RTInstance.NumEntries = (uint32)NumEntries;
+		RTInstance.bFilterWhitespaceCharactersValue = Layout.bFilterWhitespaceCharactersValue ? 1u : 0u;
+		RTInstance.TotalTextHeight = Layout.TotalTextHeight;
+		RTInstance.WindowFirstLine = Layout.WindowFirstLine;
+		RTInstance.DocumentLineCount = Layout.GetDocumentLineCount();
+
+		// Pick the compact encodings that are lossless for this layout (see NTTPackedEncoding)
+		const ENTTTextEncoding Encoding = NTTPackedEncoding::ChooseTextEncoding(Layout);
+		const bool bGlyphIndices16 = EnumHasAnyFlags(Encoding, ENTTTextEncoding::GlyphIndices16);
+		const bool bPositionsHalf = EnumHasAnyFlags(Encoding, ENTTTextEncoding::PositionsHalf);
+		const bool bCharIndices16 = EnumHasAnyFlags(Encoding, ENTTTextEncoding::CharacterIndices16);
+		const bool bTables16 = EnumHasAnyFlags(Encoding, ENTTTextEncoding::Tables16);
+		RTInstance.TextEncoding = (uint32)Encoding;
+
+		// Per-character data goes into records when the layout fits them, replacing the four per-character arrays below
+		RTInstance.bHasCharRecords = NumChars > 0 && NTTPackedEncoding::AreCharacterRecordsEnabled() && NTTPackedEncoding::CanBuildCharacterRecords(Layout);
+		const int32 NumCharsInTextBuffer = RTInstance.bHasCharRecords ? 0 : NumChars;
+
+		if (RTInstance.bHasCharRecords)
+		{
+			const uint32 RecordBytes = NumChars * sizeof(FUintVector4);
+			RTInstance.CharRecordBuffer = GNTTBufferPool.Acquire_RT(RHICmdList, TEXT("NTT_CharRecordBuffer"), sizeof(FUintVector4), NumChars);
+			FUintVector4* DestRecords = (FUintVector4*)RHICmdList.LockBuffer(RTInstance.CharRecordBuffer->Buffer, 0, RecordBytes, RLM_WriteOnly);
+			NTTPackedEncoding::WriteCharacterRecords(DestRecords, Layout);
+			RHICmdList.UnlockBuffer(RTInstance.CharRecordBuffer->Buffer);
+		}
 
 		// Calculate offsets (in floats) directly into the struct
-		RTInstance.Offset_UVs = 0;
-		uint32 CurrentOffset = RTInstance.Offset_UVs + NumRects * 4;
+		RTInstance.Offset_GlyphIndices = 0;
+		uint32 CurrentOffset = RTInstance.Offset_GlyphIndices + NTTPackedEncoding::GetIntSlots(NumCharsInTextBuffer, bGlyphIndices16);
 
-		RTInstance.Offset_Sizes = CurrentOffset;
-		CurrentOffset += NumRects * 2;
+		RTInstance.Offset_Positions = CurrentOffset;
+		CurrentOffset += NTTPackedEncoding::GetPositionSlots(NumCharsInTextBuffer, bPositionsHalf);
 
-		RTInstance.Offset_Unicode = CurrentOffset;
-		CurrentOffset += NumChars * 1;
+		RTInstance.Offset_CharLine = CurrentOffset;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(NumCharsInTextBuffer, bCharIndices16);
 
-		RTInstance.Offset_Positions = CurrentOffset;
-		CurrentOffset += NumChars * 2;
+		RTInstance.Offset_CharWord = CurrentOffset;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(NumCharsInTextBuffer, bCharIndices16);
 
 		RTInstance.Offset_LineStart = CurrentOffset;
-		CurrentOffset += NumLines * 1;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(NumLines, bTables16);
 
 		RTInstance.Offset_LineCount = CurrentOffset;
-		CurrentOffset += NumLines * 1;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(NumLines, bTables16);
 
 		RTInstance.Offset_WordStart = CurrentOffset;
-		CurrentOffset += NumWords * 1;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(NumWords, bTables16);
 
 		RTInstance.Offset_WordCount = CurrentOffset;
-		CurrentOffset += NumWords * 1;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(NumWords, bTables16);
+
+		RTInstance.Offset_WordPrefix = CurrentOffset;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(Layout.WordCharacterCountPrefix.Num(), bTables16);
+
+		RTInstance.Offset_WordTrailingPrefix = CurrentOffset;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(Layout.WordWithTrailingWhitespacePrefix.Num(), bTables16);
+
+		RTInstance.Offset_LinePrefix = CurrentOffset;
+		CurrentOffset += NTTPackedEncoding::GetIntSlots(Layout.LineCharacterCountPrefix.Num(), bTables16);
+
+		// Entry tables are small and always stay 32-bit
+		RTInstance.Offset_CharEntry = CurrentOffset;
+		CurrentOffset += Layout.CharacterEntryIndices.Num();
+
+		RTInstance.Offset_EntryStart = CurrentOffset;
+		CurrentOffset += NumEntries * 1;
+
+		RTInstance.Offset_EntryCount = CurrentOffset;
+		CurrentOffset += NumEntries * 1;
 
 		const uint32 TotalFloats = FMath::Max(CurrentOffset, 1u);
 
-		// Initialize buffer
-		RTInstance.PackedBuffer.Initialize(RHICmdList, TEXT("NTT_PackedBuffer"), sizeof(float), TotalFloats, BUF_ShaderResource | BUF_Static);
+		// Pooled buffers can be larger than needed, only the used part is written
+		RTInstance.TextBuffer = GNTTBufferPool.Acquire_RT(RHICmdList, TEXT("NTT_TextBuffer"), sizeof(float), TotalFloats);
 
-		float* DestInfo = (float*)RHICmdList.LockBuffer(RTInstance.PackedBuffer.Buffer, 0, TotalFloats * sizeof(float), RLM_WriteOnly);
+		float* DestInfo = (float*)RHICmdList.LockBuffer(RTInstance.TextBuffer->Buffer, 0, TotalFloats * sizeof(float), RLM_WriteOnly);
 
 		// Helper to safely write data
 		if (TotalFloats == 1 && CurrentOffset == 0)
@@ -187,94 +712,191 @@ struct FNDIFontUVInfoProxy : public FNiagaraDataInterfaceProxy
 		}
 		else
 		{
-			// UVs (float4)
-			for (int32 i = 0; i < NumRects; ++i)
+			if (!RTInstance.bHasCharRecords)
 			{
-				const FVector4& Src = InstanceDataFromGT->CharacterTextureUvs[i];
-				int32 Base = RTInstance.Offset_UVs + i * 4;
-				DestInfo[Base + 0] = (float)Src.X;
-				DestInfo[Base + 1] = (float)Src.Y;
-				DestInfo[Base + 2] = (float)Src.Z;
-				DestInfo[Base + 3] = (float)Src.W;
-			}
+				// Glyph indices and positions
+				NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_GlyphIndices], Layout.GlyphIndices, bGlyphIndices16);
+				NTTPackedEncoding::WritePositions(&DestInfo[RTInstance.Offset_Positions], Layout.CharacterPositions, bPositionsHalf);
 
-			// Sizes (float2)
-			for (int32 i = 0; i < NumRects; ++i)
-			{
-				const FVector2f& Src = InstanceDataFromGT->CharacterSpriteSizes[i];
-				int32 Base = RTInstance.Offset_Sizes + i * 2;
-				DestInfo[Base + 0] = Src.X;
-				DestInfo[Base + 1] = Src.Y;
+				// Per-character line and word indices
+				NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_CharLine], Layout.CharacterLineIndices, bCharIndices16);
+				NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_CharWord], Layout.CharacterWordIndices, bCharIndices16);
 			}
 
-			// Unicode (int32 -> asfloat)
-			for (int32 i = 0; i < NumChars; ++i)
-			{
-				int32 Src = InstanceDataFromGT->Unicode[i];
-				int32 Base = RTInstance.Offset_Unicode + i;
-				FMemory::Memcpy(&DestInfo[Base], &Src, sizeof(int32));
-			}
-
-			// Positions (float2)
-			for (int32 i = 0; i < NumChars; ++i)
-			{
-				const FVector2f& Src = InstanceDataFromGT->CharacterPositions[i];
-				int32 Base = RTInstance.Offset_Positions + i * 2;
-				DestInfo[Base + 0] = Src.X;
-				DestInfo[Base + 1] = Src.Y;
-			}
+			// Line and word tables
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_LineStart], Layout.LineStartIndices, bTables16);
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_LineCount], Layout.LineCharacterCounts, bTables16);
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_WordStart], Layout.WordStartIndices, bTables16);
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_WordCount], Layout.WordCharacterCounts, bTables16);
+
+			// Prefix sums
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_WordPrefix], Layout.WordCharacterCountPrefix, bTables16);
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_WordTrailingPrefix], Layout.WordWithTrailingWhitespacePrefix, bTables16);
+			NTTPackedEncoding::WriteInts(&DestInfo[RTInstance.Offset_LinePrefix], Layout.LineCharacterCountPrefix, bTables16);
+
+			// Multi-text entry tables, empty outside of multi-text mode
+			FMemory::Memcpy(&DestInfo[RTInstance.Offset_CharEntry], Layout.CharacterEntryIndices.GetData(), Layout.CharacterEntryIndices.Num() * sizeof(int32));
+			FMemory::Memcpy(&DestInfo[RTInstance.Offset_EntryStart], Layout.EntryStartIndices.GetData(), NumEntries * sizeof(int32));
+			FMemory::Memcpy(&DestInfo[RTInstance.Offset_EntryCount], Layout.EntryCharacterCounts.GetData(), NumEntries * sizeof(int32));
+		}
 
-			// LineStartIndices (int32)
-			for (int32 i = 0; i < NumLines; ++i)
-			{
-				int32 Src = InstanceDataFromGT->LineStartIndices[i];
-				int32 Base = RTInstance.Offset_LineStart + i;
-				FMemory::Memcpy(&DestInfo[Base], &Src, sizeof(int32));
-			}
+		RHICmdList.UnlockBuffer(RTInstance.TextBuffer->Buffer);
+	}
 
-			// LineCharacterCounts (int32)
-			for (int32 i = 0; i < NumLines; ++i)
-			{
-				int32 Src = InstanceDataFromGT->LineCharacterCounts[i];
-				int32 Base = RTInstance.Offset_LineCount + i;
-				FMemory::Memcpy(&DestInfo[Base], &Src, sizeof(int32));
-			}
+	// Uploads the instance's pending entry origins and times
+	void UpdateEntryPlacements_RT(FRTInstanceData& RTInstance, FRHICommandListBase& RHICmdList)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NTT_BufferUpload);
+		LLM_SCOPE_BYTAG(NTT_GPUBuffers);
 
-			// WordStartIndices (int32)
-			for (int32 i = 0; i < NumWords; ++i)
-			{
-				int32 Src = InstanceDataFromGT->WordStartIndices[i];
-				int32 Base = RTInstance.Offset_WordStart + i;
-				FMemory::Memcpy(&DestInfo[Base], &Src, sizeof(int32));
-			}
+		const FNTTEntryPlacementsRef Placements = MoveTemp(RTInstance.PendingEntryPlacements);
+		RTInstance.bEntryUploadPending = false;
+		RTInstance.ReleaseEntryPlacements();
 
-			// WordCharacterCounts (int32)
-			for (int32 i = 0; i < NumWords; ++i)
-			{
-				int32 Src = InstanceDataFromGT->WordCharacterCounts[i];
-				int32 Base = RTInstance.Offset_WordCount + i;
-				FMemory::Memcpy(&DestInfo[Base], &Src, sizeof(int32));
-			}
+		const int32 NumEntries = Placements.IsValid() ? Placements->Num() : 0;
+		if (NumEntries == 0)
+		{
+			return;
 		}
 
-		RHICmdList.UnlockBuffer(RTInstance.PackedBuffer.Buffer);
+		RTInstance.Offset_EntryOrigin = 0;
+		RTInstance.Offset_EntryTime = NumEntries * 3;
+		const uint32 TotalFloats = NumEntries * 5;
+
+		RTInstance.EntryBuffer = GNTTBufferPool.Acquire_RT(RHICmdList, TEXT("NTT_EntryBuffer"), sizeof(float), TotalFloats);
+		float* DestEntries = (float*)RHICmdList.LockBuffer(RTInstance.EntryBuffer->Buffer, 0, TotalFloats * sizeof(float), RLM_WriteOnly);
+		FMemory::Memcpy(&DestEntries[RTInstance.Offset_EntryOrigin], Placements->EntryOrigins.GetData(), NumEntries * sizeof(FVector3f));
+		FMemory::Memcpy(&DestEntries[RTInstance.Offset_EntryTime], Placements->EntryTimes.GetData(), NumEntries * sizeof(FVector2f));
+		RHICmdList.UnlockBuffer(RTInstance.EntryBuffer->Buffer);
 	}
 
 	virtual void ConsumePerInstanceDataFromGameThread(void* PerInstanceData, const FNiagaraSystemInstanceID& InstanceID) override
 	{
-		UE_LOG(LogNiagaraTextToolkit, Log, TEXT("NTT DI Proxy: ConsumePerInstanceDataFromGameThread - Proxy=%p, InstanceID=%llu"), 
-			this, (uint64)InstanceID);
+		SCOPE_CYCLE_COUNTER(STAT_NTT_ConsumeRenderThreadData);
+
+		FNDIFontUVInfoRenderThreadData* DataFromGT = static_cast<FNDIFontUVInfoRenderThreadData*>(PerInstanceData);
+
+		// Buffers stay resident until the layout actually changes. The upload itself waits for PreStage.
+		if (DataFromGT->bLayoutChanged)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(NTT_ReceiveLayout, NTTChannel);
+
+			FRTInstanceData& RTInstance = AddInstance_RT(InstanceID, DataFromGT->Slot);
+			RTInstance.PendingGlyphTable = DataFromGT->GlyphTable;
+			RTInstance.PendingLayout = DataFromGT->Layout;
+			RTInstance.PendingLayoutVersion = DataFromGT->LayoutVersion;
+			RTInstance.bUploadPending = true;
+		}
 
-		FNDIFontUVInfoInstanceData* InstanceDataFromGT = static_cast<FNDIFontUVInfoInstanceData*>(PerInstanceData);
-		FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+		if (DataFromGT->bEntryPlacementsChanged)
+		{
+			FRTInstanceData& RTInstance = AddInstance_RT(InstanceID, DataFromGT->Slot);
+			RTInstance.PendingEntryPlacements = DataFromGT->EntryPlacements;
+			RTInstance.bEntryUploadPending = true;
+		}
 
-		UpdateData_RT(InstanceDataFromGT, InstanceID, RHICmdList);
+		if (InstanceSlots_RT.IsValidIndex(DataFromGT->Slot) && InstanceSlots_RT[DataFromGT->Slot].InstanceID == InstanceID)
+		{
+			InstanceSlots_RT[DataFromGT->Slot].EntryClock = DataFromGT->EntryClock;
+			InstanceSlots_RT[DataFromGT->Slot].bLayoutReady = DataFromGT->bLayoutReady ? 1u : 0u;
+		}
 
 		// Call the destructor to clean up the GT data
-		InstanceDataFromGT->~FNDIFontUVInfoInstanceData();
+		DataFromGT->~FNDIFontUVInfoRenderThreadData();
+	}
+
+	virtual void PreStage(const FNDIGpuComputePreStageContext& Context) override
+	{
+		FRTInstanceData* RTInstance = FindInstance_RT(Context.GetSystemInstanceID());
+		if (RTInstance && RTInstance->bUploadPending)
+		{
+			UpdateData_RT(*RTInstance, Context.GetGraphBuilder().RHICmdList);
+		}
+		if (RTInstance && RTInstance->bEntryUploadPending)
+		{
+			UpdateEntryPlacements_RT(*RTInstance, Context.GetGraphBuilder().RHICmdList);
+		}
+	}
+
+	// Bucket of InstanceID in a SlotTable_RT of Mask + 1 entries. Instance IDs are handed out sequentially, so the low bits
+	// alone give live instances their own buckets.
+	static uint32 GetSlotTableBucket(FNiagaraSystemInstanceID InstanceID, uint32 Mask)
+	{
+		return (uint32)(InstanceID ^ (InstanceID >> 32)) & Mask;
+	}
+
+	// Adds a slot whose InstanceID is set, growing the table to keep it at most half full
+	void AddToSlotTable_RT(int32 Slot)
+	{
+		if ((NumSlotTableEntries_RT + 1) * 2 > SlotTable_RT.Num())
+		{
+			SlotTable_RT.Init(INDEX_NONE, FMath::Max(16, (int32)FMath::RoundUpToPowerOfTwo((NumSlotTableEntries_RT + 1) * 4)));
+			NumSlotTableEntries_RT = 0;
+			for (int32 InUseSlot = 0; InUseSlot < InstanceSlots_RT.Num(); ++InUseSlot)
+			{
+				if (InstanceSlots_RT[InUseSlot].bInUse && InUseSlot != Slot)
+				{
+					InsertIntoSlotTable_RT(InUseSlot);
+				}
+			}
+		}
+		InsertIntoSlotTable_RT(Slot);
+	}
+
+	void InsertIntoSlotTable_RT(int32 Slot)
+	{
+		const uint32 Mask = SlotTable_RT.Num() - 1;
+		uint32 Bucket = GetSlotTableBucket(InstanceSlots_RT[Slot].InstanceID, Mask);
+		while (SlotTable_RT[Bucket] != INDEX_NONE)
+		{
+			Bucket = (Bucket + 1) & Mask;
+		}
+		SlotTable_RT[Bucket] = Slot;
+		++NumSlotTableEntries_RT;
 	}
 
-	TMap<FNiagaraSystemInstanceID, FRTInstanceData> SystemInstancesToInstanceData_RT;
+	void RemoveFromSlotTable_RT(int32 Slot)
+	{
+		if (SlotTable_RT.Num() == 0)
+		{
+			return;
+		}
+
+		const uint32 Mask = SlotTable_RT.Num() - 1;
+		uint32 Hole = GetSlotTableBucket(InstanceSlots_RT[Slot].InstanceID, Mask);
+		while (SlotTable_RT[Hole] != Slot)
+		{
+			if (SlotTable_RT[Hole] == INDEX_NONE)
+			{
+				return;
+			}
+			Hole = (Hole + 1) & Mask;
+		}
+
+		// Pull later entries of the probe run back into the hole, so lookups never stop early at it
+		for (uint32 Next = (Hole + 1) & Mask; SlotTable_RT[Next] != INDEX_NONE; Next = (Next + 1) & Mask)
+		{
+			const uint32 Home = GetSlotTableBucket(InstanceSlots_RT[SlotTable_RT[Next]].InstanceID, Mask);
+			if (((Next - Home) & Mask) >= ((Next - Hole) & Mask))
+			{
+				SlotTable_RT[Hole] = SlotTable_RT[Next];
+				Hole = Next;
+			}
+		}
+		SlotTable_RT[Hole] = INDEX_NONE;
+		--NumSlotTableEntries_RT;
+	}
+
+	// Render thread instance data, indexed by the slot the game thread assigned to the instance
+	TArray<FRTInstanceData> InstanceSlots_RT;
+	// Open addressed table from instance ID to slot for FindInstance_RT, INDEX_NONE in empty buckets. Power of two sized.
+	TArray<int32> SlotTable_RT;
+	int32 NumSlotTableEntries_RT = 0;
+
+	// Slot allocator, game thread side
+	FCriticalSection SlotLock_GT;
+	TArray<int32> FreeSlots_GT;
+	int32 NumSlots_GT = 0;
 };
 
 UCLASS(EditInlineNew, BlueprintType, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "NTT Data Interface"))
@@ -284,29 +906,51 @@ class NIAGARATEXTTOOLKIT_API UNTTDataInterface : public UNiagaraDataInterface
 
 public:
 	BEGIN_SHADER_PARAMETER_STRUCT(FShaderParameters, )
-		SHADER_PARAMETER_SRV(StructuredBuffer<float>, PackedBuffer)
+		SHADER_PARAMETER_SRV(StructuredBuffer<float>, GlyphBuffer)
+		SHADER_PARAMETER_SRV(StructuredBuffer<float>, TextBuffer)
+		SHADER_PARAMETER_SRV(StructuredBuffer<uint4>, CharRecordBuffer)
+		SHADER_PARAMETER_SRV(StructuredBuffer<float>, EntryBuffer)
 
 		SHADER_PARAMETER(uint32, Offset_UVs)
 		SHADER_PARAMETER(uint32, Offset_Sizes)
-		SHADER_PARAMETER(uint32, Offset_Unicode)
+		SHADER_PARAMETER(uint32, Offset_GlyphIndices)
 		SHADER_PARAMETER(uint32, Offset_Positions)
+		SHADER_PARAMETER(uint32, Offset_CharLine)
+		SHADER_PARAMETER(uint32, Offset_CharWord)
 		SHADER_PARAMETER(uint32, Offset_LineStart)
 		SHADER_PARAMETER(uint32, Offset_LineCount)
 		SHADER_PARAMETER(uint32, Offset_WordStart)
 		SHADER_PARAMETER(uint32, Offset_WordCount)
+		SHADER_PARAMETER(uint32, Offset_WordPrefix)
+		SHADER_PARAMETER(uint32, Offset_WordTrailingPrefix)
+		SHADER_PARAMETER(uint32, Offset_LinePrefix)
+		SHADER_PARAMETER(uint32, Offset_CharEntry)
+		SHADER_PARAMETER(uint32, Offset_EntryStart)
+		SHADER_PARAMETER(uint32, Offset_EntryCount)
+		SHADER_PARAMETER(uint32, Offset_EntryOrigin)
+		SHADER_PARAMETER(uint32, Offset_EntryTime)
 
 		SHADER_PARAMETER(uint32, NumRects)
 		SHADER_PARAMETER(uint32, NumChars)
 		SHADER_PARAMETER(uint32, NumLines)
 		SHADER_PARAMETER(uint32, NumWords)
+		SHADER_PARAMETER(uint32, NumEntries)
 		SHADER_PARAMETER(uint32, bFilterWhitespaceCharactersValue)
 		SHADER_PARAMETER(float, TotalTextHeight)
+		SHADER_PARAMETER(uint32, TextVersion)
+		SHADER_PARAMETER(float, EntryClock)
+		SHADER_PARAMETER(uint32, TextEncoding)
+		SHADER_PARAMETER(uint32, GlyphEncoding)
+		SHADER_PARAMETER(uint32, bHasCharRecords)
+		SHADER_PARAMETER(uint32, bLayoutReady)
+		SHADER_PARAMETER(int32, WindowFirstLine)
+		SHADER_PARAMETER(int32, DocumentLineCount)
 	END_SHADER_PARAMETER_STRUCT()
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Font Asset"))
 	UFont* FontAsset = nullptr;
 
-	// The input text to compute character positions for; converted to Unicode and character positions per instance
+	// The input text to compute character positions for; converted to glyph indices and character positions per instance
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Input Text", MultiLine = "true"))
 	FString InputText;
 
@@ -328,6 +972,98 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (DisplayName = "Filter Whitespace Characters"))
 	bool bFilterWhitespaceCharacters = true;
 
+	// Shows NumericValue formatted with NumericFormat instead of InputText.
+	// Numeric updates skip the layout cache and rebuild into layouts the instance already owns, so they don't allocate.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Numeric Mode"))
+	bool bNumericMode = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Numeric Value", EditCondition = "bNumericMode"))
+	double NumericValue = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Numeric Format", EditCondition = "bNumericMode"))
+	FNTTNumericFormat NumericFormat;
+
+	// Shows every text entry added with AddTextEntry, each laid out around its own origin, instead of InputText.
+	// Lets one system instance render many independent strings (see GetCharacterEntry and GetTextEntryInfo).
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Multi-Text Mode"))
+	bool bMultiTextMode = false;
+
+	// Only lays out and uploads StreamingWindowLines lines of InputText, starting at StreamingScrollLine.
+	// For very long texts such as credits or logs; character, line and word indices are relative to the window.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Streaming Mode"))
+	bool bStreamingMode = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Streaming Window Lines", ClampMin = "1", EditCondition = "bStreamingMode"))
+	int32 StreamingWindowLines = 40;
+
+	// First line of InputText inside the window
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Streaming Scroll Line", ClampMin = "0", EditCondition = "bStreamingMode"))
+	int32 StreamingScrollLine = 0;
+
+	// Keeps character, line and word counts for gameplay queries on instances in minimal mode (dedicated servers and -nullrhi,
+	// see ntt.MinimalMode). Without it those instances report an empty text.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (DisplayName = "Counts In Minimal Mode"))
+	bool bCountsInMinimalMode = false;
+
+	// Replaces InputText and leaves numeric and multi-text modes. Running instances redo their layout on their next tick
+	// without reinitializing the system.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void SetInputText(const FString& NewText);
+
+	// Replaces FontAsset. Running instances redo their layout on their next tick without reinitializing the system.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void SetFontAsset(UFont* NewFont);
+
+	// Switches to numeric mode and shows NewValue. Running instances redo their layout on their next tick; setting the value
+	// it already shows does nothing.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void SetNumericValue(double NewValue);
+
+	// Replaces NumericFormat. Running instances redo their layout on their next tick.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void SetNumericFormat(const FNTTNumericFormat& NewFormat);
+
+	// Switches to multi-text mode and adds a text entry at Origin. Entries with a Lifetime above zero are removed
+	// automatically once they are that many seconds old; the others stay until RemoveTextEntry or ClearTextEntries.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (AdvancedDisplay = "Lifetime"))
+	FNTTTextEntryHandle AddTextEntry(const FString& Text, FVector Origin, float Lifetime = 0.0f);
+
+	// Returns false if the entry was already removed
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	bool RemoveTextEntry(FNTTTextEntryHandle Handle);
+
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	bool SetTextEntryText(FNTTTextEntryHandle Handle, const FString& NewText);
+
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	bool SetTextEntryOrigin(FNTTTextEntryHandle Handle, FVector NewOrigin);
+
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void ClearTextEntries();
+
+	UFUNCTION(BlueprintPure, Category = "Niagara Text Toolkit Plugin")
+	int32 GetNumTextEntries() const;
+
+	// Moves the streaming window so it starts at NewScrollLine. Only the lines inside the new window are laid out again.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void SetStreamingScrollLine(int32 NewScrollLine);
+
+	// Returns the number of lines in InputText, for scroll bars and auto-scrolling in streaming mode
+	UFUNCTION(BlueprintPure, Category = "Niagara Text Toolkit Plugin")
+	int32 GetDocumentLineCount() const;
+
+	// Call after writing any layout property directly so running instances pick up the change on their next tick.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void MarkLayoutDirty();
+
+	// Returns a consistent copy of the layout properties. Safe to call while a setter runs on another thread.
+	// In numeric mode the value is formatted into OutNumericText if given (and bNumericText is set), otherwise into InputText.
+	// In streaming mode the window is copied into OutWindowText if given (and bWindowText is set), otherwise into InputText.
+	FNTTLayoutParams GetLayoutParams(FNTTNumericTextBuilder* OutNumericText = nullptr, FString* OutWindowText = nullptr) const;
+
+	// Runs the full layout for Params using the shared glyph table for Params.FontAsset.
+	static FNTTTextLayoutRef BuildLayout(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params);
+
 	//UObject Interface
 	virtual void PostInitProperties() override;
 	//UObject Interface End
@@ -349,6 +1085,9 @@ public:
 	virtual void DestroyPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance) override;
 	virtual int32 PerInstanceDataSize() const override;
 	virtual void ProvidePerInstanceDataForRenderThread(void* DataForRenderThread, void* PerInstanceData, const FNiagaraSystemInstanceID& SystemInstance) override;
+	virtual bool HasPreSimulateTick() const override { return true; }
+	virtual void BeginDestroy() override;
+	virtual bool PerInstanceTick(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance, float DeltaSeconds) override;
 	//UNiagaraDataInterface Interface
 
 	void GetCharacterUVVM(FVectorVMExternalFunctionContext& Context);
@@ -364,6 +1103,18 @@ public:
 	void GetCharacterCountInLineRangeVM(FVectorVMExternalFunctionContext& Context);
 	void GetCharacterSpriteSizeVM(FVectorVMExternalFunctionContext& Context);
 	void GetTextHeightVM(FVectorVMExternalFunctionContext& Context);
+	void GetTextVersionVM(FVectorVMExternalFunctionContext& Context);
+	void GetCharacterLineIndexVM(FVectorVMExternalFunctionContext& Context);
+	void GetCharacterWordIndexVM(FVectorVMExternalFunctionContext& Context);
+	void GetCharacterIndexInLineVM(FVectorVMExternalFunctionContext& Context);
+	void GetCharacterIndexInWordVM(FVectorVMExternalFunctionContext& Context);
+	void GetCharacterNormalizedIndexVM(FVectorVMExternalFunctionContext& Context);
+	void GetTextEntryCountVM(FVectorVMExternalFunctionContext& Context);
+	void GetCharacterEntryVM(FVectorVMExternalFunctionContext& Context);
+	void GetTextEntryInfoVM(FVectorVMExternalFunctionContext& Context);
+	void GetLayoutReadyVM(FVectorVMExternalFunctionContext& Context);
+	void GetWindowFirstLineVM(FVectorVMExternalFunctionContext& Context);
+	void GetDocumentLineCountVM(FVectorVMExternalFunctionContext& Context);
 
 	/** Returns the render thread proxy for this data interface. */
 	FNDIFontUVInfoProxy* GetFontProxy() const { return static_cast<FNDIFontUVInfoProxy*>(Proxy.Get()); }
@@ -382,23 +1133,75 @@ private:
 	static const FName GetCharacterCountInLineRangeName;
 	static const FName GetCharacterSpriteSizeName;
 	static const FName GetTextHeightName;
+	static const FName GetTextVersionName;
+	static const FName GetCharacterLineIndexName;
+	static const FName GetCharacterWordIndexName;
+	static const FName GetCharacterIndexInLineName;
+	static const FName GetCharacterIndexInWordName;
+	static const FName GetCharacterNormalizedIndexName;
+	static const FName GetTextEntryCountName;
+	static const FName GetCharacterEntryName;
+	static const FName GetTextEntryInfoName;
+	static const FName GetLayoutReadyName;
+	static const FName GetWindowFirstLineName;
+	static const FName GetDocumentLineCountName;
+
+	struct FTextEntry
+	{
+		FString Text;
+		FVector3f Origin = FVector3f::ZeroVector;
+		// FApp::GetCurrentTime() when the entry was added
+		double AddTime = 0.0;
+		// Seconds, 0 for entries that live until they are removed
+		float Lifetime = 0.0f;
+		int32 Serial = 0;
+		// Bumped by SetTextEntryText, so a layout built from the previous text is never stored in Layout
+		uint32 TextVersion = 0;
+		// Text laid out with the glyph table and settings in TextEntryLayoutsKey, null until an instance lays it out.
+		// Entries that didn't change skip the string copy and the layout cache on every update.
+		mutable FNTTTextLayoutRef Layout;
+	};
+
+	// Re-runs layout for one instance from the current property values.
+	void UpdateInstanceLayout(FNDIFontUVInfoInstanceData& InstanceData) const;
+
+	// Lays out every text entry and combines them into one layout for the instance
+	void UpdateMultiTextLayout(FNDIFontUVInfoInstanceData& InstanceData, FNTTGlyphTableRef GlyphTable, const FNTTLayoutParams& Params) const;
+
+	// Minimal mode: counts only, or an empty text (see bCountsInMinimalMode)
+	void UpdateMinimalLayout(FNDIFontUVInfoInstanceData& InstanceData, const FNTTLayoutParams& Params, FStringView Text) const;
+
+	// Compares the text entries of both data interfaces under their locks, for Equals
+	bool AreTextEntriesEqual(const UNTTDataInterface& Other) const;
+
+	// Removes entries whose lifetime has run out. Returns true if any were removed.
+	bool RemoveExpiredTextEntries(double CurrentTime);
+
+	// Caller must hold ParameterLock
+	FTextEntry* FindTextEntryLocked(FNTTTextEntryHandle Handle);
+	void UpdateNextTextEntryExpiryLocked();
+	void UpdateStreamingLineStartsLocked() const;
+
+	// Bumped by the setters; instances compare it against the revision their layout was built from.
+	std::atomic<uint32> ParameterRevision{ 1 };
+
+	// Guards the layout properties while they are written by the setters and read by GetLayoutParams
+	mutable FCriticalSection ParameterLock;
+
+	// Multi-text entries, guarded by ParameterLock. Runtime only, never serialized.
+	TSparseArray<FTextEntry> TextEntries;
+	int32 NextTextEntrySerial = 1;
+	// FApp::GetCurrentTime() entry times are measured from; reset whenever the first entry is added to an empty set
+	double TextEntryClockBase = 0.0;
+	// Glyph table and settings the entries' layouts were built with (its text is always empty). Entries are laid out again
+	// when they change.
+	mutable FNTTLayoutCacheKey TextEntryLayoutsKey;
 
-	// Computes per-character positions in local text space using per-glyph sprite sizes in pixels.
-	static TArray<FVector2f> GetCharacterPositions(const TArray<FVector2f>& CharacterSpriteSizes, const TArray<int32>& VerticalOffsets, int32 Kerning, float ExtraVerticalOffset, float ExtraKerningOffset, float WhitespaceWidthMultiplier, FString InputString, ENTTTextHorizontalAlignment XAlignment, ENTTTextVerticalAlignment YAlignment, float& OutTotalHeight);
-
-	// Extracts per-glyph sprite sizes (pixels), normalized texture UVs, vertical offsets, and global kerning from the font asset.
-	static bool GetFontInfo(const UFont* FontAsset, TArray<FVector4>& OutCharacterTextureUvs, TArray<FVector2f>& OutCharacterSpriteSizes, TArray<int32>& OutVerticalOffsets, int32& OutKerning);
-
-	static void ProcessText(
-		const FString& InputText,
-		const TArray<FVector2f>& CharacterPositionsUnfiltered,
-		const bool bFilterWhitespace,
-		TArray<int32>& OutUnicode,
-		TArray<FVector2f>& OutCharacterPositions,
-		TArray<int32>& OutLineStartIndices,
-		TArray<int32>& OutLineCharacterCounts,
-		TArray<int32>& OutWordStartIndices,
-		TArray<int32>& OutWordCharacterCounts
-	);
+	// Streaming mode: offset of every line of InputText, guarded by ParameterLock.
+	// Valid for ParameterRevision StreamingLineStartsRevision, scrolling keeps it valid.
+	mutable TArray<int32> StreamingLineStarts;
+	mutable uint32 StreamingLineStartsRevision = 0;
+	// Earliest time an entry expires, so ticks only take the lock when something actually has to be removed
+	std::atomic<double> NextTextEntryExpiry{ TNumericLimits<double>::Max() };
 
 };
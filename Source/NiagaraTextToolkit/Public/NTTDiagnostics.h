@@ -0,0 +1,74 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NiagaraCommon.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UNiagaraSystem;
+class UNTTDataInterface;
+struct FNDIFontUVInfoInstanceData;
+struct FNDIFontUVInfoProxy;
+
+// Memory and size of one live NTT instance, as reported by ntt.DumpInstances and ntt.MemReport
+struct FNTTInstanceSnapshot
+{
+	FNiagaraSystemInstanceID InstanceID = 0;
+	FString SystemName;
+	FString FontName;
+	int32 NumCharacters = 0;
+	// Instance block plus its layout and entry placements. Layouts can be shared with other instances and the layout cache.
+	SIZE_T CPUBytes = 0;
+	// Text and character record buffers owned by the instance
+	SIZE_T GPUBytes = 0;
+
+	// Shared data, only counted once per layout or font when aggregating
+	const void* Layout = nullptr;
+	SIZE_T LayoutBytes = 0;
+	uint32 GlyphTableId = 0;
+	SIZE_T GlyphTableBytes = 0;
+	SIZE_T GlyphBufferBytes = 0;
+
+	// Multi-text entry origins and times, owned by the instance
+	const void* EntryPlacements = nullptr;
+};
+
+// Tracks every live NTT instance for the diagnostics console commands. Instances register in InitPerInstanceData
+// and unregister in DestroyPerInstanceData.
+class NIAGARATEXTTOOLKIT_API FNTTInstanceRegistry
+{
+public:
+	static FNTTInstanceRegistry& Get();
+
+	// Hooks ntt.MemReport into memreport, called by the module
+	void Initialize();
+	void Shutdown();
+
+	void Register(const FNDIFontUVInfoInstanceData* InstanceData, FNDIFontUVInfoProxy* Proxy, FNiagaraSystemInstanceID InstanceID,
+		const UNTTDataInterface* DataInterface, const UNiagaraSystem* System);
+	void Unregister(const FNDIFontUVInfoInstanceData* InstanceData);
+
+	int32 Num() const;
+
+	// Game thread only. Flushes rendering commands to read each instance's GPU buffers.
+	TArray<FNTTInstanceSnapshot> Gather() const;
+
+	// Writes the live instances, largest first
+	void DumpInstances(FOutputDevice& Ar) const;
+
+	// Writes NTT memory per font and per system asset, along with the shared caches and pools
+	void MemReport(FOutputDevice& Ar) const;
+
+private:
+	struct FEntry
+	{
+		FNDIFontUVInfoProxy* Proxy = nullptr;
+		FNiagaraSystemInstanceID InstanceID = 0;
+		TWeakObjectPtr<const UNTTDataInterface> DataInterface;
+		TWeakObjectPtr<const UNiagaraSystem> System;
+	};
+
+	mutable FCriticalSection Lock;
+	TMap<const FNDIFontUVInfoInstanceData*, FEntry> Entries;
+};
@@ -0,0 +1,145 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UFont;
+
+// Glyph UVs and sizes as float SoA for the VM kernels. Every channel has one trailing all-zero glyph
+// (at index NumGlyphs) that characters without a glyph are redirected to, so kernels never branch per instance.
+struct FNTTGlyphChannels
+{
+	TArray<float> USize;
+	TArray<float> VSize;
+	TArray<float> UStart;
+	TArray<float> VStart;
+	TArray<float> Width;
+	TArray<float> Height;
+};
+
+// Immutable glyph data extracted from an offline font.
+// One table is shared by every NTT instance that uses the same font, so it must never be modified after it is built.
+// Glyph arrays are dense: code points that share a glyph (CharRemap, or empty entries of non-remapped fonts) share its index.
+// Code points are mapped to glyph indices through a direct Latin-1 table and a hash map for everything above it.
+struct NIAGARATEXTTOOLKIT_API FNTTGlyphTable
+{
+	static constexpr int32 NumLatin1CodePoints = 256;
+
+	// Normalized per-glyph UVs in texture space: (USize, VSize, UStart, VStart), all in 0-1
+	TArray<FVector4f> GlyphTextureUvs;
+	// Per-glyph sprite size in pixels: (Width, Height)
+	TArray<FVector2f> GlyphSpriteSizes;
+	// Per-glyph offset from the line's origin to the top of the glyph, in pixels
+	TArray<int32> GlyphVerticalOffsets;
+	// Glyph index for code points 0-255, INDEX_NONE if the font has no glyph for it
+	int32 Latin1GlyphIndices[NumLatin1CodePoints];
+	// Glyph index for code points above Latin-1
+	TMap<uint32, int32> ExtendedGlyphIndices;
+	// Same data as GlyphTextureUvs and GlyphSpriteSizes, split per channel for the VM
+	FNTTGlyphChannels Channels;
+	// Global kerning of the font, in pixels
+	int32 Kerning = 0;
+	// Tallest glyph in the font, used as the fallback height for lines without drawable characters
+	float MaxGlyphHeight = 0.0f;
+	// Process-unique id of this table. A rebuilt table always gets a new id.
+	uint32 TableId = 0;
+
+	FNTTGlyphTable()
+	{
+		for (int32& GlyphIndex : Latin1GlyphIndices)
+		{
+			GlyphIndex = INDEX_NONE;
+		}
+	}
+
+	bool IsValid() const { return GlyphSpriteSizes.Num() > 0; }
+	int32 NumGlyphs() const { return GlyphSpriteSizes.Num(); }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return sizeof(FNTTGlyphTable)
+			+ GlyphTextureUvs.GetAllocatedSize()
+			+ GlyphSpriteSizes.GetAllocatedSize()
+			+ GlyphVerticalOffsets.GetAllocatedSize()
+			+ ExtendedGlyphIndices.GetAllocatedSize()
+			+ Channels.USize.GetAllocatedSize()
+			+ Channels.VSize.GetAllocatedSize()
+			+ Channels.UStart.GetAllocatedSize()
+			+ Channels.VStart.GetAllocatedSize()
+			+ Channels.Width.GetAllocatedSize()
+			+ Channels.Height.GetAllocatedSize();
+	}
+
+	// Returns the glyph index for a code point, or INDEX_NONE if the font has no glyph for it.
+	FORCEINLINE int32 FindGlyphIndex(uint32 CodePoint) const
+	{
+		if (CodePoint < (uint32)NumLatin1CodePoints)
+		{
+			return Latin1GlyphIndices[CodePoint];
+		}
+		const int32* Found = ExtendedGlyphIndices.Find(CodePoint);
+		return Found ? *Found : INDEX_NONE;
+	}
+
+	// Index into Channels for a glyph index; anything out of range maps to the trailing zero glyph.
+	FORCEINLINE int32 GetChannelSlot(int32 GlyphIndex) const
+	{
+		return (uint32)GlyphIndex < (uint32)NumGlyphs() ? GlyphIndex : NumGlyphs();
+	}
+
+	// Fills Channels from the glyph arrays. Called once while building the table.
+	void BuildChannels();
+};
+
+typedef TSharedPtr<const FNTTGlyphTable, ESPMode::ThreadSafe> FNTTGlyphTableRef;
+
+// Process-wide cache of glyph tables, keyed by font, font texture size and cache generation.
+// Safe to use from any thread.
+class NIAGARATEXTTOOLKIT_API FNTTFontGlyphCache
+{
+public:
+	static FNTTFontGlyphCache& Get();
+
+	// Returns the shared glyph table for FontAsset, building it on first use.
+	// Returns an empty (invalid) table if the font is null or not an offline cached font.
+	FNTTGlyphTableRef FindOrBuild(const UFont* FontAsset);
+
+	// Drops the cached table for FontAsset. Instances holding the old table keep it alive until they are reinitialized.
+	void Invalidate(const UFont* FontAsset);
+
+	// Drops every cached table and bumps the cache generation.
+	void InvalidateAll();
+
+	// Removes entries whose font has been garbage collected.
+	void PurgeStaleEntries();
+
+	// Registers the editor/GC callbacks that keep the cache in sync with font assets.
+	void Initialize();
+	void Shutdown();
+
+private:
+	struct FCacheEntry
+	{
+		FNTTGlyphTableRef Table;
+		FIntPoint TextureSize = FIntPoint::ZeroValue;
+		uint32 Generation = 0;
+	};
+
+	static FIntPoint GetFontTextureSize(const UFont* FontAsset);
+	static FNTTGlyphTableRef BuildTable(const UFont* FontAsset);
+
+#if WITH_EDITOR
+	void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+
+	FCriticalSection CacheLock;
+	TMap<TObjectKey<UFont>, FCacheEntry> Entries;
+	uint32 Generation = 1;
+
+	FDelegateHandle PostGarbageCollectHandle;
+#if WITH_EDITOR
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+};
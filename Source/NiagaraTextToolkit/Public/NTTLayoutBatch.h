@@ -0,0 +1,21 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NTTTextLayout.h"
+
+struct FNTTLayoutParams;
+
+// Lays out many strings at once, for frames where a lot of NTT systems are spawned together.
+// Results go into FNTTLayoutCache, so the InitPerInstanceData of every system spawned with the same
+// font, text and settings afterwards just claims the precomputed layout.
+class NIAGARATEXTTOOLKIT_API FNTTLayoutBatch
+{
+public:
+	// Lays out every request that isn't cached yet in parallel and adds the results to the layout cache.
+	// Duplicate requests are only laid out once. If OutLayouts is given it receives one layout per request, in order.
+	// The cache keeps at most ntt.LayoutCache.Capacity layouts within ntt.LayoutCache.MaxBytes; a batch that doesn't fit logs
+	// a warning, and only the layouts held in OutLayouts are guaranteed to survive it.
+	static void Prewarm(TConstArrayView<FNTTLayoutParams> Requests, TArray<FNTTTextLayoutRef>* OutLayouts = nullptr);
+};
@@ -0,0 +1,106 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "NTTTextLayout.h"
+
+struct FNTTGlyphTable;
+struct FNTTLayoutParams;
+
+// Everything a finished layout depends on. The glyph table id stands in for the font:
+// it changes whenever the font, its texture or the glyph cache generation changes.
+struct FNTTLayoutCacheKey
+{
+	uint32 GlyphTableId = 0;
+	FString Text;
+	uint8 HorizontalAlignment = 0;
+	uint8 VerticalAlignment = 0;
+	float VerticalOffset = 0.0f;
+	float KerningOffset = 0.0f;
+	float WhitespaceWidthMultiplier = 1.0f;
+	bool bFilterWhitespaceCharacters = true;
+	uint32 Hash = 0;
+
+	FNTTLayoutCacheKey() = default;
+	FNTTLayoutCacheKey(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params);
+
+	bool operator==(const FNTTLayoutCacheKey& Other) const
+	{
+		return Hash == Other.Hash
+			&& GlyphTableId == Other.GlyphTableId
+			&& HorizontalAlignment == Other.HorizontalAlignment
+			&& VerticalAlignment == Other.VerticalAlignment
+			&& VerticalOffset == Other.VerticalOffset
+			&& KerningOffset == Other.KerningOffset
+			&& WhitespaceWidthMultiplier == Other.WhitespaceWidthMultiplier
+			&& bFilterWhitespaceCharacters == Other.bFilterWhitespaceCharacters
+			&& Text.Equals(Other.Text, ESearchCase::CaseSensitive);
+	}
+
+	friend uint32 GetTypeHash(const FNTTLayoutCacheKey& Key)
+	{
+		return Key.Hash;
+	}
+};
+
+struct FNTTLayoutCacheStats
+{
+	uint64 Hits = 0;
+	uint64 Misses = 0;
+	uint64 Evictions = 0;
+	int32 NumEntries = 0;
+	SIZE_T NumBytes = 0;
+	// Current limits, from ntt.LayoutCache.Capacity and ntt.LayoutCache.MaxBytes
+	int32 Capacity = 0;
+	SIZE_T MaxBytes = 0;
+};
+
+// Process-wide, bounded LRU cache of finished layouts, shared by every NTT instance.
+// Repeated spawns of the same text with the same font and settings get the same immutable layout block.
+// Bounded by ntt.LayoutCache.Capacity entries and ntt.LayoutCache.MaxBytes bytes. Safe to use from any thread.
+class NIAGARATEXTTOOLKIT_API FNTTLayoutCache
+{
+public:
+	static FNTTLayoutCache& Get();
+
+	// Returns the cached layout for Params, building and caching it on a miss.
+	FNTTTextLayoutRef FindOrBuild(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params);
+
+	// Returns the cached layout for Params or null, without building anything.
+	FNTTTextLayoutRef Find(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params);
+
+	// Adds a layout that was built elsewhere. Keeps the existing entry if there already is one.
+	void Add(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, FNTTTextLayoutRef Layout);
+
+	// Drops every cached layout. Instances keep the layouts they already hold.
+	void Empty();
+
+	FNTTLayoutCacheStats GetStats() const;
+
+	// Bytes a cached layout of Text counts against ntt.LayoutCache.MaxBytes
+	static SIZE_T GetEntryBytes(const FString& Text, const FNTTTextLayout& Layout);
+
+private:
+	struct FCacheEntry
+	{
+		FNTTTextLayoutRef Layout;
+		SIZE_T NumBytes = 0;
+	};
+
+	FNTTLayoutCache();
+
+	// Caller must hold CacheLock
+	FNTTTextLayoutRef FindLocked(const FNTTLayoutCacheKey& Key);
+	void AddLocked(FNTTLayoutCacheKey&& Key, FNTTTextLayoutRef Layout);
+	void EvictLocked(int32 MaxEntries, SIZE_T MaxBytes);
+	void ApplyCapacityLocked();
+
+	mutable FCriticalSection CacheLock;
+	TLruCache<FNTTLayoutCacheKey, FCacheEntry> Entries;
+	SIZE_T NumBytes = 0;
+	uint64 Hits = 0;
+	uint64 Misses = 0;
+	uint64 Evictions = 0;
+};
@@ -0,0 +1,84 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FNTTTextLayout;
+struct FNTTGlyphTable;
+
+// Which parts of an instance's text buffer use the compact 16-bit encodings.
+// Mirrored by the TextEncoding shader parameter and decoded in NTTDataInterface.ush.
+enum class ENTTTextEncoding : uint32
+{
+	None = 0,
+	// Glyph indices as uint16, two per slot
+	GlyphIndices16 = 1 << 0,
+	// Character positions as half2, one per slot
+	PositionsHalf = 1 << 1,
+	// Per-character line and word indices as uint16
+	CharacterIndices16 = 1 << 2,
+	// Line/word start, count and prefix sum tables as uint16
+	Tables16 = 1 << 3,
+};
+ENUM_CLASS_FLAGS(ENTTTextEncoding)
+
+// CPU side of the compact GPU buffer encodings. Everything here must stay in sync with the Load* helpers in NTTDataInterface.ush.
+// Buffers are StructuredBuffer<float>, so packed values are stored as raw bits in 32-bit slots.
+// Packed ints hold two 16-bit values per slot, low half first; 0xFFFF stands for INDEX_NONE.
+namespace NTTPackedEncoding
+{
+	// Largest value a packed 16-bit int can hold
+	constexpr int32 MaxPacked16Value = 0xFFFE;
+
+	// True when ntt.CompactGPUEncoding is enabled
+	NIAGARATEXTTOOLKIT_API bool IsCompactEncodingEnabled();
+
+	// Picks the compact encodings that are lossless for Layout, or None if compact encoding is disabled
+	NIAGARATEXTTOOLKIT_API ENTTTextEncoding ChooseTextEncoding(const FNTTTextLayout& Layout);
+
+	// Whether a glyph table's UV rects and sprite sizes should be uploaded compactly
+	NIAGARATEXTTOOLKIT_API bool ShouldUseCompactGlyphs(const FNTTGlyphTable& GlyphTable);
+
+	// True if every value fits a packed 16-bit int
+	NIAGARATEXTTOOLKIT_API bool CanPack16(TConstArrayView<int32> Values);
+
+	// True if every component survives a round trip through half precision unchanged
+	NIAGARATEXTTOOLKIT_API bool CanPackHalfExact(TConstArrayView<FVector2f> Values);
+
+	NIAGARATEXTTOOLKIT_API uint32 PackUint16x2(int32 Low, int32 High);
+	NIAGARATEXTTOOLKIT_API int32 UnpackUint16(uint32 Bits, int32 HalfIndex);
+	NIAGARATEXTTOOLKIT_API uint32 PackHalf2(float Low, float High);
+	NIAGARATEXTTOOLKIT_API FVector2f UnpackHalf2(uint32 Bits);
+	NIAGARATEXTTOOLKIT_API uint32 PackUnorm16x2(float Low, float High);
+	NIAGARATEXTTOOLKIT_API FVector2f UnpackUnorm16x2(uint32 Bits);
+
+	// Number of 32-bit slots Count values take up
+	FORCEINLINE int32 GetIntSlots(int32 Count, bool bPacked16) { return bPacked16 ? (Count + 1) / 2 : Count; }
+	FORCEINLINE int32 GetPositionSlots(int32 Count, bool bHalf) { return bHalf ? Count : Count * 2; }
+	FORCEINLINE int32 GetGlyphUVSlots(int32 NumGlyphs, bool bCompact) { return NumGlyphs * (bCompact ? 2 : 4); }
+	FORCEINLINE int32 GetGlyphSizeSlots(int32 NumGlyphs, bool bCompact) { return NumGlyphs * (bCompact ? 1 : 2); }
+
+	// Writes/reads int tables, character positions and glyph data in either encoding
+	NIAGARATEXTTOOLKIT_API void WriteInts(float* Dest, TConstArrayView<int32> Values, bool bPacked16);
+	NIAGARATEXTTOOLKIT_API int32 ReadInt(const float* Src, int32 Index, bool bPacked16);
+	NIAGARATEXTTOOLKIT_API void WritePositions(float* Dest, TConstArrayView<FVector2f> Values, bool bHalf);
+	NIAGARATEXTTOOLKIT_API FVector2f ReadPosition(const float* Src, int32 Index, bool bHalf);
+	NIAGARATEXTTOOLKIT_API void WriteGlyphUVs(float* Dest, TConstArrayView<FVector4f> Values, bool bCompact);
+	NIAGARATEXTTOOLKIT_API FVector4f ReadGlyphUV(const float* Src, int32 GlyphIndex, bool bCompact);
+	NIAGARATEXTTOOLKIT_API void WriteGlyphSizes(float* Dest, TConstArrayView<FVector2f> Values, bool bCompact);
+	NIAGARATEXTTOOLKIT_API FVector2f ReadGlyphSize(const float* Src, int32 GlyphIndex, bool bCompact);
+
+	// True when ntt.CharacterRecords is enabled
+	NIAGARATEXTTOOLKIT_API bool AreCharacterRecordsEnabled();
+
+	// Whether every character of Layout fits a record: glyph and line indices must fit 16 bits
+	NIAGARATEXTTOOLKIT_API bool CanBuildCharacterRecords(const FNTTTextLayout& Layout);
+
+	// One uint4 per character so the shader gets everything per-character in a single load:
+	// (position X bits, position Y bits, glyph index | line index << 16, word index).
+	// Returns false and leaves OutRecords empty if the layout doesn't fit (see CanBuildCharacterRecords).
+	NIAGARATEXTTOOLKIT_API bool BuildCharacterRecords(const FNTTTextLayout& Layout, TArray<FUintVector4>& OutRecords);
+	NIAGARATEXTTOOLKIT_API void WriteCharacterRecords(FUintVector4* Dest, const FNTTTextLayout& Layout);
+	NIAGARATEXTTOOLKIT_API void ReadCharacterRecord(const FUintVector4& Record, FVector2f& OutPosition, int32& OutGlyphIndex, int32& OutLineIndex, int32& OutWordIndex);
+}
@@ -0,0 +1,63 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// "stat NTT" in game or the Stats tab in Unreal Insights
+DECLARE_STATS_GROUP(TEXT("Niagara Text Toolkit"), STATGROUP_NTT, STATCAT_Advanced);
+
+// Per-stage timings
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Glyph Table Build"), STAT_NTT_GlyphTableBuild, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Text Processing"), STAT_NTT_TextProcessing, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Layout"), STAT_NTT_Layout, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GT to RT Copy"), STAT_NTT_ProvideRenderThreadData, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RT Consume"), STAT_NTT_ConsumeRenderThreadData, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RT Buffer Upload"), STAT_NTT_BufferUpload, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+
+// Counters. Live Instances persists across frames, the others are reset every frame.
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Instances"), STAT_NTT_LiveInstances, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Instance Inits"), STAT_NTT_InstanceInits, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Layout Updates"), STAT_NTT_LayoutUpdates, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Characters Laid Out"), STAT_NTT_CharactersLaidOut, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Buffer Uploads"), STAT_NTT_BufferUploads, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("In-Place Layout Allocations"), STAT_NTT_InPlaceLayoutAllocations, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+
+// Memory
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Instance Data (CPU)"), STAT_NTT_InstanceMemory, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Layout Cache (CPU)"), STAT_NTT_LayoutCacheMemory, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Text Buffers (GPU)"), STAT_NTT_TextBufferMemory, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Idle Pooled Buffers (GPU)"), STAT_NTT_PooledBufferMemory, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Glyph Buffers (GPU)"), STAT_NTT_GlyphBufferMemory, STATGROUP_NTT, NIAGARATEXTTOOLKIT_API);
+
+// LLM tags ("stat LLM", memreport). NTT_GPUBuffers covers RHI buffer allocations, so on platforms whose RHI reports
+// to LLM it holds the GPU memory of text and glyph buffers.
+LLM_DECLARE_TAG_API(NTT, NIAGARATEXTTOOLKIT_API);
+LLM_DECLARE_TAG_API(NTT_GPUBuffers, NIAGARATEXTTOOLKIT_API);
+
+// "csvcategory NTT" or -csvCategories=NTT
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(NIAGARATEXTTOOLKIT_API, NTT);
+
+// Fine-grained events (uploads, removals) only recorded with -trace=NTT. Disabled channels cost one branch.
+UE_TRACE_CHANNEL_EXTERN(NTTChannel, NIAGARATEXTTOOLKIT_API);
+
+namespace NTTStats
+{
+	// Keep the live instance stat, CSV stat and trace counter in sync. Safe to call from any thread.
+	NIAGARATEXTTOOLKIT_API void OnInstanceCreated(SIZE_T InstanceBytes);
+	NIAGARATEXTTOOLKIT_API void OnInstanceDestroyed(SIZE_T InstanceBytes);
+	NIAGARATEXTTOOLKIT_API int32 GetNumLiveInstances();
+
+	// Called once per finished layout, from whichever thread built it
+	NIAGARATEXTTOOLKIT_API void OnCharactersLaidOut(int32 NumCharacters);
+
+	// Numeric and streaming modes, and multi-text entries that only moved, rebuild layouts the instance owns, so this only
+	// grows while every one of them is still in use. The total never resets.
+	NIAGARATEXTTOOLKIT_API void OnInPlaceLayoutAllocated();
+	NIAGARATEXTTOOLKIT_API int32 GetNumInPlaceLayoutAllocations();
+}
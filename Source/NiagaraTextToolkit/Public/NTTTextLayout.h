@@ -0,0 +1,129 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FNTTGlyphTable;
+struct FNTTLayoutParams;
+
+// Finished layout of one text string. Immutable once built, so it can be shared between
+// the game thread instance data and the render thread without copying the arrays.
+struct NIAGARATEXTTOOLKIT_API FNTTTextLayout
+{
+	// Index into the font's glyph table per character, INDEX_NONE if the font has no glyph for it
+	TArray<int32> GlyphIndices;
+	TArray<FVector2f> CharacterPositions;
+	// Line of each character
+	TArray<int32> CharacterLineIndices;
+	// Word of each character. Whitespace belongs to the word before it, INDEX_NONE before the first word.
+	TArray<int32> CharacterWordIndices;
+	TArray<int32> LineStartIndices;
+	TArray<int32> LineCharacterCounts;
+	TArray<int32> WordStartIndices;
+	TArray<int32> WordCharacterCounts;
+	// Prefix sums with a leading zero (NumWords + 1 / NumLines + 1 entries): element i is the total of the first i
+	// words/lines, so the character count of any word or line range is two loads and a subtraction.
+	TArray<int32> WordCharacterCountPrefix;
+	TArray<int32> WordWithTrailingWhitespacePrefix;
+	TArray<int32> LineCharacterCountPrefix;
+	float TotalTextHeight = 0.0f;
+	bool bFilterWhitespaceCharactersValue = true;
+
+	// Multi-text mode only, empty otherwise. Every entry is laid out on its own around its origin and the
+	// results are concatenated; characters, lines and words are numbered across all entries.
+	// Entry of each character
+	TArray<int32> CharacterEntryIndices;
+	TArray<int32> EntryStartIndices;
+	TArray<int32> EntryCharacterCounts;
+
+	// Streaming mode only: document line the first line of this layout is, and the line count of the whole document.
+	// 0 otherwise, in which case the layout is the whole document.
+	int32 WindowFirstLine = 0;
+	int32 DocumentLineCount = 0;
+
+	int32 NumCharacters() const { return GlyphIndices.Num(); }
+	int32 NumLines() const { return LineStartIndices.Num(); }
+	int32 NumWords() const { return WordStartIndices.Num(); }
+	int32 NumEntries() const { return EntryStartIndices.Num(); }
+	int32 GetDocumentLineCount() const { return (DocumentLineCount > 0) ? DocumentLineCount : NumLines(); }
+
+	// Characters in the text. Same as NumCharacters(), except for counts-only layouts (see FNTTTextLayoutEngine::BuildCounts)
+	// which have no per-character data.
+	int32 GetCharacterCount() const { return (LineCharacterCountPrefix.Num() > 0) ? LineCharacterCountPrefix.Last() : NumCharacters(); }
+
+	// Position of a character within its line/word. Trailing whitespace continues counting past the end of its word.
+	int32 GetCharacterIndexInLine(int32 CharacterIndex) const
+	{
+		return CharacterIndex - LineStartIndices[CharacterLineIndices[CharacterIndex]];
+	}
+
+	int32 GetCharacterIndexInWord(int32 CharacterIndex) const
+	{
+		const int32 WordIndex = CharacterWordIndices[CharacterIndex];
+		return (WordIndex >= 0) ? CharacterIndex - WordStartIndices[WordIndex] : 0;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return GlyphIndices.GetAllocatedSize()
+			+ CharacterPositions.GetAllocatedSize()
+			+ CharacterLineIndices.GetAllocatedSize()
+			+ CharacterWordIndices.GetAllocatedSize()
+			+ LineStartIndices.GetAllocatedSize()
+			+ LineCharacterCounts.GetAllocatedSize()
+			+ WordStartIndices.GetAllocatedSize()
+			+ WordCharacterCounts.GetAllocatedSize()
+			+ WordCharacterCountPrefix.GetAllocatedSize()
+			+ WordWithTrailingWhitespacePrefix.GetAllocatedSize()
+			+ LineCharacterCountPrefix.GetAllocatedSize()
+			+ CharacterEntryIndices.GetAllocatedSize()
+			+ EntryStartIndices.GetAllocatedSize()
+			+ EntryCharacterCounts.GetAllocatedSize();
+	}
+
+	// Rebuilds the prefix sum tables from the word and line tables
+	void BuildPrefixSums();
+};
+
+typedef TSharedPtr<const FNTTTextLayout, ESPMode::ThreadSafe> FNTTTextLayoutRef;
+
+// Multi-text mode: where each entry of a layout is placed and when it was added. Kept out of the layout, so moving an entry
+// replaces this small block and leaves the characters, their layout and their GPU buffer alone.
+struct FNTTEntryPlacements
+{
+	TArray<FVector3f> EntryOrigins;
+	// Per entry: (time the entry was added, lifetime in seconds), relative to EntryClockBase
+	TArray<FVector2f> EntryTimes;
+	// FApp::GetCurrentTime() that entry times are measured from
+	double EntryClockBase = 0.0;
+
+	int32 Num() const { return EntryOrigins.Num(); }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return EntryOrigins.GetAllocatedSize() + EntryTimes.GetAllocatedSize();
+	}
+};
+
+typedef TSharedPtr<const FNTTEntryPlacements, ESPMode::ThreadSafe> FNTTEntryPlacementsRef;
+
+// Lays out text in a single pass over the string plus one fix-up pass over the lines.
+// Measures lines, filters whitespace, builds the line/word tables and places glyphs line-locally as it goes,
+// then offsets every line by its alignment once the line widths and total height are known.
+// Texts longer than ntt.ParallelLayoutThreshold are split at line breaks and their lines are walked on worker threads,
+// with the same result as the single-threaded path.
+struct NIAGARATEXTTOOLKIT_API FNTTTextLayoutEngine
+{
+	// Builds the layout of Text into OutLayout. OutLayout is reset first; its array allocations are reused.
+	// Params.InputText is ignored so callers can lay out text that doesn't live in an FString.
+	static void Build(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, FStringView Text, FNTTTextLayout& OutLayout);
+
+	// Builds only the line and word tables of Text, the same ones Build would, without a font. The per-character arrays
+	// stay empty, so NumCharacters() is 0; use GetCharacterCount() instead. Used when nothing is rendered (see ntt.MinimalMode).
+	static void BuildCounts(const FNTTLayoutParams& Params, FStringView Text, FNTTTextLayout& OutLayout);
+
+	// Concatenates independently built layouts into OutLayout, one entry per part. Line and word indices are offset
+	// so they stay unique, and the entry tables are filled. Origins and times live in FNTTEntryPlacements.
+	static void Combine(TConstArrayView<FNTTTextLayoutRef> Parts, FNTTTextLayout& OutLayout);
+};
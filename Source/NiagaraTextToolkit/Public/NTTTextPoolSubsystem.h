@@ -0,0 +1,97 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NTTTextPoolSubsystem.generated.h"
+
+class UNiagaraComponent;
+class UNiagaraSystem;
+class UNTTDataInterface;
+
+// One pooled component together with its resolved NTT data interface, so handing it out never scans the user parameters
+USTRUCT()
+struct FNTTPooledText
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TObjectPtr<UNiagaraComponent> Component = nullptr;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UNTTDataInterface> DataInterface = nullptr;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UNiagaraSystem> System = nullptr;
+};
+
+USTRUCT()
+struct FNTTTextPool
+{
+	GENERATED_BODY()
+
+	// Inactive components ready to be handed out
+	UPROPERTY(Transient)
+	TArray<FNTTPooledText> FreeTexts;
+
+	// Largest Count passed to PrewarmPool. The pool keeps this many free components even above ntt.TextPool.MaxFreePerSystem.
+	UPROPERTY(Transient)
+	int32 PrewarmedCount = 0;
+};
+
+// Per-world pool of NTT Niagara components for short-lived text such as damage numbers and pickup text.
+// Components are created once, handed out with new text and transform, and go back to the pool when
+// their system finishes instead of being destroyed.
+UCLASS()
+class NIAGARATEXTTOOLKIT_API UNTTTextPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// Creates components for System until its pool holds at least Count free ones. Count also raises the number of
+	// released components the pool keeps for System above ntt.TextPool.MaxFreePerSystem.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin")
+	void PrewarmPool(UNiagaraSystem* System, int32 Count);
+
+	// Activates a pooled component for System with Text at the given transform, creating one if the pool is empty.
+	// The component returns to the pool when its system finishes, or when it is passed to ReleaseText.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Spawn Pooled NTT Text"))
+	UNiagaraComponent* SpawnText(UNiagaraSystem* System, const FString& Text, FVector Location, FRotator Rotation);
+
+	// Stops a component handed out by SpawnText immediately and returns it to the pool.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Release Pooled NTT Text"))
+	void ReleaseText(UNiagaraComponent* Component);
+
+	// Number of free components currently pooled for System
+	UFUNCTION(BlueprintPure, Category = "Niagara Text Toolkit Plugin")
+	int32 GetNumFreeTexts(UNiagaraSystem* System) const;
+
+	//USubsystem Interface
+	virtual void Deinitialize() override;
+	//USubsystem Interface End
+
+protected:
+	//UWorldSubsystem Interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//UWorldSubsystem Interface End
+
+private:
+
+	// Creates and registers a new inactive component for System. Returns false if System has no NTT user parameter.
+	bool CreatePooledText(UNiagaraSystem* System, FNTTPooledText& OutText);
+
+	// Deactivates the text and puts it back in its pool, or destroys it if the pool is full
+	void ReturnToPool(FNTTPooledText&& Text);
+
+	UFUNCTION()
+	void OnPooledSystemFinished(UNiagaraComponent* Component);
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UNiagaraSystem>, FNTTTextPool> Pools;
+
+	// Components currently handed out, keyed by component
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UNiagaraComponent>, FNTTPooledText> ActiveTexts;
+};
@@ -0,0 +1,197 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTTextLayout.h"
+
+// Batch kernels behind the NTT DI's VM functions. They write plain float arrays and read character indices through any
+// type with IsConstant() and GetAndAdvance(), so the VM passes its FNDIInputParam<int32> and benchmarks pass
+// FArrayIndexInput. Null destinations are skipped.
+namespace NTTVMKernels
+{
+	// Character indices read from a plain array, with the same interface as FNDIInputParam<int32>
+	struct FArrayIndexInput
+	{
+		const int32* Data = nullptr;
+		// 0 when every instance reads Data[0], like a constant VM register
+		int32 Stride = 1;
+
+		bool IsConstant() const { return Stride == 0; }
+
+		int32 GetAndAdvance()
+		{
+			const int32 Value = *Data;
+			Data += Stride;
+			return Value;
+		}
+	};
+
+	// Writes Value to Dest[0, Count)
+	FORCEINLINE void SplatFloat(float* RESTRICT Dest, int32 Count, float Value)
+	{
+		if (Dest == nullptr)
+		{
+			return;
+		}
+
+		const VectorRegister4Float Splat = VectorSetFloat1(Value);
+		int32 i = 0;
+		for (; i + 4 <= Count; i += 4)
+		{
+			VectorStore(Splat, Dest + i);
+		}
+		for (; i < Count; ++i)
+		{
+			Dest[i] = Value;
+		}
+	}
+
+	FORCEINLINE void SplatInt(int32* RESTRICT Dest, int32 Count, int32 Value)
+	{
+		if (Dest == nullptr)
+		{
+			return;
+		}
+
+		const VectorRegister4Int Splat = VectorIntSet1(Value);
+		int32 i = 0;
+		for (; i + 4 <= Count; i += 4)
+		{
+			VectorIntStore(Splat, Dest + i);
+		}
+		for (; i < Count; ++i)
+		{
+			Dest[i] = Value;
+		}
+	}
+
+	// Gathers Src[Slots[0..3]] into one register and stores it at Dest[Offset]
+	FORCEINLINE void GatherStore4(float* RESTRICT Dest, int32 Offset, const float* RESTRICT Src, const int32* Slots)
+	{
+		if (Dest != nullptr)
+		{
+			VectorStore(MakeVectorRegisterFloat(Src[Slots[0]], Src[Slots[1]], Src[Slots[2]], Src[Slots[3]]), Dest + Offset);
+		}
+	}
+
+	// Wraps a particle's character index into the text. Negative indices stay negative and are treated as invalid.
+	FORCEINLINE int32 WrapCharacterIndex(int32 CharacterIndex, int32 NumChars)
+	{
+		// Particles usually map one to one to characters, so only indices past the end pay for the division
+		if ((uint32)CharacterIndex < (uint32)NumChars)
+		{
+			return CharacterIndex;
+		}
+		return NumChars > 0 ? CharacterIndex % NumChars : INDEX_NONE;
+	}
+
+	// Slot in FNTTGlyphTable::Channels for a particle's character index
+	FORCEINLINE int32 GetGlyphSlot(const FNTTTextLayout& Layout, const FNTTGlyphTable& GlyphTable, int32 CharacterIndex)
+	{
+		const int32 WrappedIndex = WrapCharacterIndex(CharacterIndex, Layout.NumCharacters());
+		const int32 GlyphIndex = (WrappedIndex >= 0) ? Layout.GlyphIndices.GetData()[WrappedIndex] : INDEX_NONE;
+		return GlyphTable.GetChannelSlot(GlyphIndex);
+	}
+
+	// Looks up a glyph channel for every instance: a single splat when the index is uniform, otherwise 4-wide gathers.
+	template<int32 NumChannels, typename IndexInputType>
+	void GatherGlyphChannels(int32 NumInstances, const FNTTTextLayout& Layout, const FNTTGlyphTable& GlyphTable, IndexInputType& InCharacterIndex, const float* const (&Src)[NumChannels], float* const (&Dest)[NumChannels])
+	{
+		if (InCharacterIndex.IsConstant())
+		{
+			const int32 Slot = GetGlyphSlot(Layout, GlyphTable, InCharacterIndex.GetAndAdvance());
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				SplatFloat(Dest[Channel], NumInstances, Src[Channel][Slot]);
+			}
+			return;
+		}
+
+		int32 i = 0;
+		for (; i + 4 <= NumInstances; i += 4)
+		{
+			int32 Slots[4];
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				Slots[Lane] = GetGlyphSlot(Layout, GlyphTable, InCharacterIndex.GetAndAdvance());
+			}
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				GatherStore4(Dest[Channel], i, Src[Channel], Slots);
+			}
+		}
+		for (; i < NumInstances; ++i)
+		{
+			const int32 Slot = GetGlyphSlot(Layout, GlyphTable, InCharacterIndex.GetAndAdvance());
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				if (Dest[Channel] != nullptr)
+				{
+					Dest[Channel][i] = Src[Channel][Slot];
+				}
+			}
+		}
+	}
+
+	// Writes the world-space offset of each instance's character: X is 0, Y and Z are the layout position flipped.
+	template<typename IndexInputType>
+	void GatherCharacterPositions(int32 NumInstances, const FNTTTextLayout& Layout, IndexInputType& InCharacterIndex, float* RESTRICT DestX, float* RESTRICT DestY, float* RESTRICT DestZ)
+	{
+		const FVector2f* RESTRICT Positions = Layout.CharacterPositions.GetData();
+		const int32 NumChars = Layout.NumCharacters();
+
+		// UE Coordinates: X (forward) = 0, Y (left/right) = horizontal, Z (up/down) = vertical
+		// The position is calculated by adding the cumulative character widths and line heights (positive values)
+		// This causes the vertical component to go in the positive direction, but the final Z value should be negative
+		// for subsequent lines. Similarly the horizontal component goes in the positive direction, but positive Y
+		// in UE's cooridnate system is left, and we need the text to go right.
+		// So, we flip both values
+		auto GetFlippedPosition = [Positions, NumChars](int32 CharacterIndex) -> FVector2f
+		{
+			const int32 WrappedIndex = WrapCharacterIndex(CharacterIndex, NumChars);
+			return (WrappedIndex >= 0) ? -Positions[WrappedIndex] : FVector2f(0.0f, 0.0f);
+		};
+
+		SplatFloat(DestX, NumInstances, 0.0f);
+
+		if (InCharacterIndex.IsConstant())
+		{
+			const FVector2f Position = GetFlippedPosition(InCharacterIndex.GetAndAdvance());
+			SplatFloat(DestY, NumInstances, Position.X);
+			SplatFloat(DestZ, NumInstances, Position.Y);
+			return;
+		}
+
+		int32 i = 0;
+		for (; i + 4 <= NumInstances; i += 4)
+		{
+			const FVector2f P0 = GetFlippedPosition(InCharacterIndex.GetAndAdvance());
+			const FVector2f P1 = GetFlippedPosition(InCharacterIndex.GetAndAdvance());
+			const FVector2f P2 = GetFlippedPosition(InCharacterIndex.GetAndAdvance());
+			const FVector2f P3 = GetFlippedPosition(InCharacterIndex.GetAndAdvance());
+
+			if (DestY != nullptr)
+			{
+				VectorStore(MakeVectorRegisterFloat(P0.X, P1.X, P2.X, P3.X), DestY + i);
+			}
+			if (DestZ != nullptr)
+			{
+				VectorStore(MakeVectorRegisterFloat(P0.Y, P1.Y, P2.Y, P3.Y), DestZ + i);
+			}
+		}
+		for (; i < NumInstances; ++i)
+		{
+			const FVector2f Position = GetFlippedPosition(InCharacterIndex.GetAndAdvance());
+			if (DestY != nullptr)
+			{
+				DestY[i] = Position.X;
+			}
+			if (DestZ != nullptr)
+			{
+				DestZ[i] = Position.Y;
+			}
+		}
+	}
+}
@@ -19,11 +19,34 @@ class NIAGARATEXTTOOLKIT_API UNiagaraTextToolkitHelpers : public UBlueprintFunct
 
 public:
 
+	// Sets the text and, by default, restarts an active system so it respawns one particle per character.
+	// Clear bResetSystem to update in place instead; running instances then redo their layout on their next tick.
 	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Set Niagara Variable (NTT Text)"))
-	static void SetNiagaraNTTTextVariable(UNiagaraComponent* System, FString TextToDisplay);
+	static void SetNiagaraNTTTextVariable(UNiagaraComponent* System, FString TextToDisplay, bool bResetSystem = true);
 
+	// Sets the font and, by default, restarts an active system.
+	// Clear bResetSystem to update in place instead; running instances then redo their layout on their next tick.
 	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Set Niagara Variable (NTT Font)"))
-	static void SetNiagaraNTTFontVariable(UNiagaraComponent* System, UFont* Font);
+	static void SetNiagaraNTTFontVariable(UNiagaraComponent* System, UFont* Font, bool bResetSystem = true);
+
+	// Adds a text entry to the component's NTT DI and switches it to multi-text mode, so one system can show many strings.
+	// Entries with a Lifetime above zero are removed automatically after that many seconds.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Add NTT Text Entry", AdvancedDisplay = "Lifetime"))
+	static FNTTTextEntryHandle AddNiagaraNTTTextEntry(UNiagaraComponent* System, FString Text, FVector Origin, float Lifetime = 0.0f);
+
+	// Removes a text entry added with AddNiagaraNTTTextEntry. Returns false if it was already removed.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Remove NTT Text Entry"))
+	static bool RemoveNiagaraNTTTextEntry(UNiagaraComponent* System, FNTTTextEntryHandle Handle);
+
+	// Lays out every text in parallel with the NTT settings of System's user parameter, ahead of a mass spawn.
+	// Systems spawned afterwards with one of these texts skip their own layout. Returns the number of texts laid out or found in the cache.
+	// The layouts only live in the layout cache, so batches beyond ntt.LayoutCache.Capacity or ntt.LayoutCache.MaxBytes log a warning.
+	UFUNCTION(BlueprintCallable, Category = "Niagara Text Toolkit Plugin", meta = (DisplayName = "Prewarm NTT Text Layouts"))
+	static int32 PrewarmNTTTextLayouts(UNiagaraSystem* System, const TArray<FString>& Texts);
+
+	// Returns the first NTT data interface among the user parameters, or null.
+	// Callers that touch the same component repeatedly should cache the result (see UNTTTextPoolSubsystem).
+	static UNTTDataInterface* FindNTTDataInterface(FNiagaraUserRedirectionParameterStore& Parameters);
 
 private:
 
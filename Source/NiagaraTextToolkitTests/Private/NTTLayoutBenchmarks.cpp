@@ -0,0 +1,136 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTLegacyLayout.h"
+#include "NTTDataInterface.h"
+#include "NTTLayoutBatch.h"
+#include "NTTLayoutCache.h"
+#include "NTTTextLayout.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Layout throughput from a damage number to a whole book, on one thread and split across workers (ntt.ParallelLayoutThreshold).
+// Legacy rows time the three-pass pipeline the engine replaced, which filled fewer tables (no per-character line and word
+// indices or prefix sums), so they are the before of the single-pass engine.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutBenchmark, "NiagaraTextToolkit.Benchmark.Layout", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNTTLayoutBenchmark::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	NTTTests::FBenchmarkCsv Csv(TEXT("Layout"), TEXT("Characters,Mode,Iterations,MsPerLayout,MCharsPerSecond"));
+	const FNTTLayoutParams Params;
+
+	for (const int32 NumChars : { 10, 100, 1000, 10000, 100000, 1000000 })
+	{
+		const FString Text = NTTTests::MakeText(NumChars);
+
+		// A fresh layout every time, like an instance laying out a new text
+		auto Measure = [&](const TCHAR* ModeName, TFunctionRef<void(FNTTTextLayout&)> BuildLayout)
+		{
+			int32 Iterations = 0;
+			const double Seconds = NTTTests::TimeIterations([&]()
+			{
+				FNTTTextLayout Layout;
+				BuildLayout(Layout);
+			}, Iterations);
+
+			const FString Row = FString::Printf(TEXT("%d,%s,%d,%.4f,%.2f"), NumChars, ModeName, Iterations, Seconds * 1000.0, NumChars / Seconds / 1000000.0);
+			AddInfo(Row);
+			Csv.AddRow(Row);
+		};
+
+		Measure(TEXT("Legacy"), [&](FNTTTextLayout& Layout)
+		{
+			NTTTests::BuildLegacyLayout(*GlyphTable, Params, Text, Layout);
+		});
+
+		struct FMode
+		{
+			const TCHAR* Name;
+			int32 Threshold;
+		};
+		for (const FMode& Mode : { FMode{ TEXT("Serial"), 0 }, FMode{ TEXT("Parallel"), 1 } })
+		{
+			NTTTests::FScopedCVar Threshold(TEXT("ntt.ParallelLayoutThreshold"), Mode.Threshold);
+			Measure(Mode.Name, [&](FNTTTextLayout& Layout)
+			{
+				FNTTTextLayoutEngine::Build(*GlyphTable, Params, Text, Layout);
+			});
+		}
+	}
+
+	TestTrue(TEXT("Results written to ") + Csv.GetPath(), Csv.Write());
+	return true;
+}
+
+// Frame cost of laying out many distinct strings at once, one after another vs. through FNTTLayoutBatch
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutBatchBenchmark, "NiagaraTextToolkit.Benchmark.LayoutBatch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNTTLayoutBatchBenchmark::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	NTTTests::FBenchmarkCsv Csv(TEXT("LayoutBatch"), TEXT("Requests,Mode,Iterations,MsPerBatch,UsPerRequest"));
+	// Room for the largest batch, so prewarming it doesn't evict its own layouts
+	NTTTests::FScopedCVar CacheCapacity(TEXT("ntt.LayoutCache.Capacity"), 512);
+	FNTTLayoutCache& LayoutCache = FNTTLayoutCache::Get();
+
+	for (const int32 NumRequests : { 1, 16, 64, 256, 512 })
+	{
+		TArray<FNTTLayoutParams> Requests;
+		for (int32 RequestIdx = 0; RequestIdx < NumRequests; ++RequestIdx)
+		{
+			FNTTLayoutParams& Params = Requests.AddDefaulted_GetRef();
+			Params.FontAsset = NTTTests::LoadTestFont();
+			Params.InputText = FString::Printf(TEXT("CRITICAL HIT %d!"), 1000 + RequestIdx * 37);
+		}
+
+		for (const bool bBatch : { false, true })
+		{
+			// Every iteration starts from an empty cache, so every request is laid out
+			constexpr int32 Iterations = 20;
+			double Seconds = 0.0;
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				LayoutCache.Empty();
+				const double StartTime = FPlatformTime::Seconds();
+				if (bBatch)
+				{
+					FNTTLayoutBatch::Prewarm(Requests);
+				}
+				else
+				{
+					for (const FNTTLayoutParams& Params : Requests)
+					{
+						LayoutCache.FindOrBuild(*GlyphTable, Params);
+					}
+				}
+				Seconds += FPlatformTime::Seconds() - StartTime;
+			}
+			Seconds /= Iterations;
+
+			const FString Row = FString::Printf(TEXT("%d,%s,%d,%.4f,%.2f"), NumRequests, bBatch ? TEXT("Batch") : TEXT("Sequential"), Iterations, Seconds * 1000.0, Seconds / NumRequests * 1000000.0);
+			AddInfo(Row);
+			Csv.AddRow(Row);
+		}
+	}
+
+	LayoutCache.Empty();
+
+	TestTrue(TEXT("Results written to ") + Csv.GetPath(), Csv.Write());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
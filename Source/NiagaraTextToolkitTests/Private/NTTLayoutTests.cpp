@@ -0,0 +1,335 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTLegacyLayout.h"
+#include "NTTDataInterface.h"
+#include "NTTLayoutBatch.h"
+#include "NTTLayoutCache.h"
+#include "NTTTextLayout.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/Font.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutTablesTest, "NiagaraTextToolkit.Layout.Tables", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTLayoutTablesTest::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	const FString Text = TEXT("Hello world\r\n  foo\n");
+	FNTTLayoutParams Params;
+	FNTTTextLayout Layout;
+
+	Params.bFilterWhitespaceCharacters = true;
+	FNTTTextLayoutEngine::Build(*GlyphTable, Params, Text, Layout);
+
+	TestEqual(TEXT("Filtered character count"), Layout.NumCharacters(), 13);
+	TestEqual(TEXT("CRLF is one line break and a trailing break adds no line"), Layout.NumLines(), 2);
+	TestEqual(TEXT("Word count"), Layout.NumWords(), 3);
+	if (Layout.NumLines() == 2 && Layout.NumCharacters() == 13)
+	{
+		TestEqual(TEXT("Second line start"), Layout.LineStartIndices[1], 10);
+		TestEqual(TEXT("Second line count"), Layout.LineCharacterCounts[1], 3);
+		TestEqual(TEXT("Line of 'f'"), Layout.CharacterLineIndices[10], 1);
+		TestEqual(TEXT("Word of 'f'"), Layout.CharacterWordIndices[10], 2);
+		TestEqual(TEXT("Index of 'o' in its line"), Layout.GetCharacterIndexInLine(11), 1);
+		TestEqual(TEXT("Line prefix sum"), Layout.LineCharacterCountPrefix.Last(), 13);
+	}
+
+	Params.bFilterWhitespaceCharacters = false;
+	FNTTTextLayoutEngine::Build(*GlyphTable, Params, Text, Layout);
+
+	TestEqual(TEXT("Unfiltered character count"), Layout.NumCharacters(), 16);
+	if (Layout.NumCharacters() == 16)
+	{
+		TestEqual(TEXT("Whitespace belongs to the word before it"), Layout.CharacterWordIndices[5], 0);
+		TestEqual(TEXT("Leading whitespace belongs to the last word of the previous line"), Layout.CharacterWordIndices[11], 1);
+		TestEqual(TEXT("Words with trailing whitespace cover every character"), Layout.WordWithTrailingWhitespacePrefix.Last(), 16);
+	}
+
+	FNTTTextLayoutEngine::Build(*GlyphTable, Params, FStringView(), Layout);
+	TestEqual(TEXT("Empty text has no characters"), Layout.NumCharacters(), 0);
+	TestEqual(TEXT("Empty text is one empty line"), Layout.NumLines(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutEmptyGlyphsTest, "NiagaraTextToolkit.Layout.EmptyGlyphs", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTLayoutEmptyGlyphsTest::RunTest(const FString& Parameters)
+{
+	const UFont* Font = NTTTests::LoadTestFont();
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (Font == nullptr || !GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+	if (Font->IsRemapped)
+	{
+		AddInfo(TEXT("The test font is remapped and has no empty entries"));
+		return true;
+	}
+
+	// Code points the font didn't import are zero-width glyphs, not missing ones, so they keep taking kerning
+	int32 NumEmpty = 0;
+	TSet<int32> EmptyOffsets;
+	for (int32 CodePoint = 0; CodePoint < Font->Characters.Num(); ++CodePoint)
+	{
+		const FFontCharacter& FontChar = Font->Characters[CodePoint];
+		if (FontChar.USize != 0 || FontChar.VSize != 0)
+		{
+			continue;
+		}
+
+		const int32 GlyphIndex = GlyphTable->FindGlyphIndex((uint32)CodePoint);
+		if (GlyphIndex == INDEX_NONE)
+		{
+			AddError(FString::Printf(TEXT("Empty entry %d has no glyph"), CodePoint));
+			break;
+		}
+		TestEqual(TEXT("Empty glyph size"), GlyphTable->GlyphSpriteSizes[GlyphIndex], FVector2f::ZeroVector);
+		TestEqual(TEXT("Empty glyph offset"), GlyphTable->GlyphVerticalOffsets[GlyphIndex], (int32)FontChar.VerticalOffset);
+		++NumEmpty;
+		EmptyOffsets.Add(FontChar.VerticalOffset);
+	}
+	TestEqual(TEXT("Empty entries with the same offset share one glyph"), GlyphTable->NumGlyphs(), Font->Characters.Num() - NumEmpty + EmptyOffsets.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutLegacyTest, "NiagaraTextToolkit.Layout.MatchesLegacy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTLayoutLegacyTest::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	const FString Texts[] =
+	{
+		FString(),
+		TEXT("Hello world\r\n  foo\n"),
+		TEXT("\n\n  indented\tand tabbed \r\nlast\r"),
+		NTTTests::MakeText(5000, 70, 5),
+	};
+
+	FNTTLayoutParams Params;
+	Params.KerningOffset = 1.5f;
+	Params.VerticalOffset = 4.0f;
+	Params.WhitespaceWidthMultiplier = 2.0f;
+
+	const ENTTTextHorizontalAlignment HorizontalAlignments[] = { ENTTTextHorizontalAlignment::NTT_THA_Left, ENTTTextHorizontalAlignment::NTT_THA_Center, ENTTTextHorizontalAlignment::NTT_THA_Right };
+	const ENTTTextVerticalAlignment VerticalAlignments[] = { ENTTTextVerticalAlignment::NTT_TVA_Top, ENTTTextVerticalAlignment::NTT_TVA_Center, ENTTTextVerticalAlignment::NTT_TVA_Bottom };
+
+	for (const FString& Text : Texts)
+	{
+		for (const bool bFilterWhitespace : { true, false })
+		{
+			for (const ENTTTextHorizontalAlignment HorizontalAlignment : HorizontalAlignments)
+			{
+				for (const ENTTTextVerticalAlignment VerticalAlignment : VerticalAlignments)
+				{
+					Params.bFilterWhitespaceCharacters = bFilterWhitespace;
+					Params.HorizontalAlignment = HorizontalAlignment;
+					Params.VerticalAlignment = VerticalAlignment;
+
+					FNTTTextLayout Layout;
+					FNTTTextLayout Legacy;
+					FNTTTextLayoutEngine::Build(*GlyphTable, Params, Text, Layout);
+					NTTTests::BuildLegacyLayout(*GlyphTable, Params, Text, Legacy);
+
+					// Alignment is applied in a different order, so positions only match up to float rounding
+					const FString Name = FString::Printf(TEXT("'%s' (filtered %d, alignment %d/%d)"), *Text.Left(16).ReplaceCharWithEscapedChar(), (int32)bFilterWhitespace, (int32)HorizontalAlignment, (int32)VerticalAlignment);
+					TestTrue(*(Name + TEXT(": glyph indices")), Layout.GlyphIndices == Legacy.GlyphIndices);
+					TestTrue(*(Name + TEXT(": line starts")), Layout.LineStartIndices == Legacy.LineStartIndices);
+					TestTrue(*(Name + TEXT(": line counts")), Layout.LineCharacterCounts == Legacy.LineCharacterCounts);
+					TestTrue(*(Name + TEXT(": word starts")), Layout.WordStartIndices == Legacy.WordStartIndices);
+					TestTrue(*(Name + TEXT(": word counts")), Layout.WordCharacterCounts == Legacy.WordCharacterCounts);
+					TestEqual(*(Name + TEXT(": total height")), Layout.TotalTextHeight, Legacy.TotalTextHeight, 0.01f);
+					if (TestEqual(*(Name + TEXT(": position count")), Layout.CharacterPositions.Num(), Legacy.CharacterPositions.Num()))
+					{
+						for (int32 CharIdx = 0; CharIdx < Layout.CharacterPositions.Num(); ++CharIdx)
+						{
+							if (!Layout.CharacterPositions[CharIdx].Equals(Legacy.CharacterPositions[CharIdx], 0.01f))
+							{
+								AddError(FString::Printf(TEXT("%s: position of character %d is %s, legacy %s"), *Name, CharIdx,
+									*Layout.CharacterPositions[CharIdx].ToString(), *Legacy.CharacterPositions[CharIdx].ToString()));
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutParallelTest, "NiagaraTextToolkit.Layout.ParallelMatchesSerial", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTLayoutParallelTest::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	if (FTaskGraphInterface::Get().GetNumWorkerThreads() == 0)
+	{
+		AddInfo(TEXT("No worker threads, both layouts take the serial path"));
+	}
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		FString Text;
+		FNTTLayoutParams Params;
+	};
+	TArray<FCase> Cases;
+
+	{
+		FCase& Case = Cases.Add_GetRef({ TEXT("Short lines"), NTTTests::MakeText(300000, 80, 1) });
+		Case.Params.VerticalOffset = 3.5f;
+	}
+	{
+		FCase& Case = Cases.Add_GetRef({ TEXT("CRLF, right and bottom aligned"), NTTTests::MakeText(300000, 60, 2).Replace(TEXT("\n"), TEXT("\r\n")) });
+		Case.Params.HorizontalAlignment = ENTTTextHorizontalAlignment::NTT_THA_Right;
+		Case.Params.VerticalAlignment = ENTTTextVerticalAlignment::NTT_TVA_Bottom;
+	}
+	{
+		FCase& Case = Cases.Add_GetRef({ TEXT("Long lines, unfiltered"), NTTTests::MakeText(300000, 5000, 3) });
+		Case.Params.bFilterWhitespaceCharacters = false;
+		Case.Params.KerningOffset = 1.25f;
+	}
+	{
+		// Empty lines and lines starting with whitespace land on chunk boundaries
+		FString Text;
+		while (Text.Len() < 300000)
+		{
+			Text += TEXT("  indented words here\n\n\r\n\tand a tab\n");
+		}
+		FCase& Case = Cases.Add_GetRef({ TEXT("Empty and indented lines"), MoveTemp(Text) });
+		Case.Params.bFilterWhitespaceCharacters = false;
+		Case.Params.VerticalAlignment = ENTTTextVerticalAlignment::NTT_TVA_Top;
+	}
+
+	for (const FCase& Case : Cases)
+	{
+		FNTTTextLayout SerialLayout;
+		FNTTTextLayout ParallelLayout;
+		{
+			NTTTests::FScopedCVar Threshold(TEXT("ntt.ParallelLayoutThreshold"), 0);
+			FNTTTextLayoutEngine::Build(*GlyphTable, Case.Params, Case.Text, SerialLayout);
+		}
+		{
+			NTTTests::FScopedCVar Threshold(TEXT("ntt.ParallelLayoutThreshold"), 1);
+			FNTTTextLayoutEngine::Build(*GlyphTable, Case.Params, Case.Text, ParallelLayout);
+		}
+
+		FString Difference;
+		if (!NTTTests::AreLayoutsIdentical(SerialLayout, ParallelLayout, Difference))
+		{
+			AddError(FString::Printf(TEXT("%s: parallel layout differs from the serial one. %s"), Case.Name, *Difference));
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutCountsTest, "NiagaraTextToolkit.Layout.CountsMatchLayout", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTLayoutCountsTest::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	const FString Texts[] =
+	{
+		FString(),
+		TEXT("Hello world\r\n  foo\n"),
+		TEXT("\n\n  indented\tand tabbed \r\nlast"),
+		NTTTests::MakeText(20000, 70, 4),
+	};
+
+	for (const FString& Text : Texts)
+	{
+		for (const bool bFilterWhitespace : { true, false })
+		{
+			FNTTLayoutParams Params;
+			Params.bFilterWhitespaceCharacters = bFilterWhitespace;
+
+			FNTTTextLayout Layout;
+			FNTTTextLayout Counts;
+			FNTTTextLayoutEngine::Build(*GlyphTable, Params, Text, Layout);
+			FNTTTextLayoutEngine::BuildCounts(Params, Text, Counts);
+
+			const FString Name = FString::Printf(TEXT("'%s' (filtered %d)"), *Text.Left(16).ReplaceCharWithEscapedChar(), (int32)bFilterWhitespace);
+			TestEqual(*(Name + TEXT(": character count")), Counts.GetCharacterCount(), Layout.GetCharacterCount());
+			TestTrue(*(Name + TEXT(": line starts")), Counts.LineStartIndices == Layout.LineStartIndices);
+			TestTrue(*(Name + TEXT(": line counts")), Counts.LineCharacterCounts == Layout.LineCharacterCounts);
+			TestTrue(*(Name + TEXT(": word starts")), Counts.WordStartIndices == Layout.WordStartIndices);
+			TestTrue(*(Name + TEXT(": word counts")), Counts.WordCharacterCounts == Layout.WordCharacterCounts);
+			TestTrue(*(Name + TEXT(": word prefix")), Counts.WordCharacterCountPrefix == Layout.WordCharacterCountPrefix);
+			TestTrue(*(Name + TEXT(": word with whitespace prefix")), Counts.WordWithTrailingWhitespacePrefix == Layout.WordWithTrailingWhitespacePrefix);
+			TestTrue(*(Name + TEXT(": line prefix")), Counts.LineCharacterCountPrefix == Layout.LineCharacterCountPrefix);
+			TestEqual(*(Name + TEXT(": no per-character data")), Counts.NumCharacters(), 0);
+			TestTrue(*(Name + TEXT(": no positions")), Counts.CharacterPositions.IsEmpty());
+		}
+	}
+
+	return true;
+}
+
+// A prewarm batch larger than the layout cache warns, and OutLayouts still holds every layout
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTLayoutPrewarmBeyondCacheTest, "NiagaraTextToolkit.Layout.PrewarmBeyondCache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTLayoutPrewarmBeyondCacheTest::RunTest(const FString& Parameters)
+{
+	NTTTests::FScopedCVar CacheCapacity(TEXT("ntt.LayoutCache.Capacity"), 4);
+	FNTTLayoutCache& LayoutCache = FNTTLayoutCache::Get();
+	LayoutCache.Empty();
+
+	TArray<FNTTLayoutParams> Requests;
+	for (int32 RequestIdx = 0; RequestIdx < 8; ++RequestIdx)
+	{
+		FNTTLayoutParams& Params = Requests.AddDefaulted_GetRef();
+		Params.FontAsset = NTTTests::LoadTestFont();
+		Params.InputText = FString::Printf(TEXT("Prewarm %d"), RequestIdx);
+	}
+
+	AddExpectedError(TEXT("NTT Layout Batch: Prewarmed 8 layouts"), EAutomationExpectedErrorFlags::Contains, 1);
+	TArray<FNTTTextLayoutRef> Layouts;
+	FNTTLayoutBatch::Prewarm(Requests, &Layouts);
+
+	if (TestEqual(TEXT("Layouts returned"), Layouts.Num(), Requests.Num()))
+	{
+		for (int32 RequestIdx = 0; RequestIdx < Layouts.Num(); ++RequestIdx)
+		{
+			TestTrue(FString::Printf(TEXT("Layout %d kept"), RequestIdx), Layouts[RequestIdx].IsValid() && Layouts[RequestIdx]->NumCharacters() > 0);
+		}
+	}
+	TestTrue(TEXT("Cache stays within its capacity"), LayoutCache.GetStats().NumEntries <= 4);
+
+	LayoutCache.Empty();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,345 @@
+// Property of Lucian Tranc
+
+#include "NTTLegacyLayout.h"
+#include "NTTDataInterface.h"
+#include "NTTFontGlyphCache.h"
+#include "NTTTextLayout.h"
+
+namespace NTTLegacyLayoutPrivate
+{
+	static bool IsWhitespaceChar(int32 Code)
+	{
+		return Code == ' '
+			|| Code == '\t';
+	}
+
+	// Iterator that understands newlines and reports original source indices per character
+	struct FNTTTextIterator
+	{
+		const FString& Source;
+		const int32 Length;
+		int32 CurrentIndex;
+
+		explicit FNTTTextIterator(const FString& InSource)
+			: Source(InSource)
+			, Length(InSource.Len())
+			, CurrentIndex(0)
+		{
+		}
+
+		bool HasNextCharacter()
+		{
+			return CurrentIndex < Length;
+		}
+
+		// Newline characters ('\n' and '\r' / "\r\n") are consumed but never returned
+		bool NextCharacterInLine(int32& OutSourceIndex, TCHAR& OutChar)
+		{
+			if (CurrentIndex >= Length)
+			{
+				return false;
+			}
+
+			const TCHAR Ch = Source[CurrentIndex];
+			if (Ch == '\n')
+			{
+				++CurrentIndex;
+				return false;
+			}
+			if (Ch == '\r')
+			{
+				CurrentIndex += (CurrentIndex + 1 < Length && Source[CurrentIndex + 1] == '\n') ? 2 : 1;
+				return false;
+			}
+
+			OutSourceIndex = CurrentIndex;
+			OutChar = Ch;
+			++CurrentIndex;
+			return true;
+		}
+
+		bool PeekNextCharacterInLine(TCHAR& OutChar) const
+		{
+			if (CurrentIndex >= Length)
+			{
+				return false;
+			}
+
+			const TCHAR Ch = Source[CurrentIndex];
+			if (Ch == '\n' || Ch == '\r')
+			{
+				return false;
+			}
+
+			OutChar = Ch;
+			return true;
+		}
+	};
+
+	TArray<FVector2f> GetCharacterPositions(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, const FString& InputString, float& OutTotalHeight)
+	{
+		const TArray<FVector2f>& GlyphSpriteSizes = GlyphTable.GlyphSpriteSizes;
+		const TArray<int32>& GlyphVerticalOffsets = GlyphTable.GlyphVerticalOffsets;
+
+		TArray<FVector2f> CharacterPositionsUnfiltered;
+		OutTotalHeight = 0.0f;
+
+		const int32 TextLength = InputString.Len();
+		if (TextLength <= 0 || !GlyphTable.IsValid())
+		{
+			return CharacterPositionsUnfiltered;
+		}
+
+		CharacterPositionsUnfiltered.Init(FVector2f(0.0f, 0.0f), TextLength);
+
+		const float CharIncrement = static_cast<float>(GlyphTable.Kerning) + Params.KerningOffset;
+
+		TArray<float> LineWidths;
+		TArray<float> LineHeights;
+		TArray<float> LineTops;
+		float TotalHeight = 0.0f;
+
+		// First pass: measure every line
+		FNTTTextIterator It(InputString);
+		while (It.HasNextCharacter())
+		{
+			float LineX = 0.0f;
+			float MaxBottom = 0.0f;
+
+			int32 SourceIndex = INDEX_NONE;
+			TCHAR Ch = 0;
+			while (It.NextCharacterInLine(SourceIndex, Ch))
+			{
+				const int32 Code = static_cast<int32>(Ch);
+				const int32 GlyphIndex = GlyphTable.FindGlyphIndex(static_cast<uint32>(Code));
+				if (GlyphIndex == INDEX_NONE)
+				{
+					continue;
+				}
+
+				const FVector2f& GlyphSize = GlyphSpriteSizes[GlyphIndex];
+				float SizeX = GlyphSize.X;
+				const float SizeY = GlyphSize.Y;
+				const float TopY = static_cast<float>(GlyphVerticalOffsets[GlyphIndex]);
+				if (IsWhitespaceChar(Code))
+				{
+					SizeX *= Params.WhitespaceWidthMultiplier;
+				}
+
+				MaxBottom = FMath::Max(MaxBottom, TopY + SizeY);
+				LineX += SizeX;
+
+				TCHAR NextCh = 0;
+				if (It.PeekNextCharacterInLine(NextCh) && !FChar::IsWhitespace(NextCh))
+				{
+					LineX += CharIncrement;
+				}
+			}
+
+			LineWidths.Add(LineX);
+
+			const float LineHeight = (MaxBottom > 0.0f) ? MaxBottom : GlyphTable.MaxGlyphHeight;
+			LineHeights.Add(LineHeight);
+			LineTops.Add(TotalHeight);
+			TotalHeight += LineHeight;
+
+			if (It.HasNextCharacter())
+			{
+				TotalHeight += Params.VerticalOffset;
+			}
+		}
+
+		OutTotalHeight = TotalHeight;
+
+		const int32 NumLines = LineWidths.Num();
+		if (NumLines == 0)
+		{
+			return CharacterPositionsUnfiltered;
+		}
+
+		float VerticalOffset = 0.0f;
+		switch (Params.VerticalAlignment)
+		{
+			case ENTTTextVerticalAlignment::NTT_TVA_Center:
+			{
+				VerticalOffset = -(TotalHeight * 0.5f);
+				break;
+			}
+			case ENTTTextVerticalAlignment::NTT_TVA_Bottom:
+			{
+				VerticalOffset = -TotalHeight;
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+
+		TArray<float> LineStartX;
+		LineStartX.SetNum(NumLines);
+		for (int32 LineIdx = 0; LineIdx < NumLines; ++LineIdx)
+		{
+			const float Width = LineWidths[LineIdx];
+			switch (Params.HorizontalAlignment)
+			{
+				case ENTTTextHorizontalAlignment::NTT_THA_Center:
+				{
+					LineStartX[LineIdx] = -Width * 0.5f;
+					break;
+				}
+				case ENTTTextHorizontalAlignment::NTT_THA_Right:
+				{
+					LineStartX[LineIdx] = -Width;
+					break;
+				}
+				default:
+				{
+					LineStartX[LineIdx] = 0.0f;
+					break;
+				}
+			}
+		}
+
+		// Second pass: position every character of the original string
+		FNTTTextIterator It2(InputString);
+		for (int32 LineIdx = 0; LineIdx < NumLines && It2.HasNextCharacter(); ++LineIdx)
+		{
+			float LineX = 0.0f;
+			const float LineTop = LineTops[LineIdx] + VerticalOffset;
+
+			int32 SourceIndex = INDEX_NONE;
+			TCHAR Ch = 0;
+			while (It2.NextCharacterInLine(SourceIndex, Ch))
+			{
+				const int32 Code = static_cast<int32>(Ch);
+				const int32 GlyphIndex = GlyphTable.FindGlyphIndex(static_cast<uint32>(Code));
+				if (GlyphIndex == INDEX_NONE)
+				{
+					continue;
+				}
+
+				const FVector2f& GlyphSize = GlyphSpriteSizes[GlyphIndex];
+				float SizeX = GlyphSize.X;
+				const float SizeY = GlyphSize.Y;
+				const float TopY = static_cast<float>(GlyphVerticalOffsets[GlyphIndex]);
+				if (IsWhitespaceChar(Code))
+				{
+					SizeX *= Params.WhitespaceWidthMultiplier;
+				}
+
+				const float GlyphLeft = LineStartX[LineIdx] + LineX;
+				const float GlyphTop = LineTop + TopY;
+				CharacterPositionsUnfiltered[SourceIndex] = FVector2f(GlyphLeft + SizeX * 0.5f, GlyphTop + SizeY * 0.5f);
+
+				LineX += SizeX;
+
+				TCHAR NextCh = 0;
+				if (It2.PeekNextCharacterInLine(NextCh) && !FChar::IsWhitespace(NextCh))
+				{
+					LineX += CharIncrement;
+				}
+			}
+		}
+
+		return CharacterPositionsUnfiltered;
+	}
+
+	// Third pass: filters whitespace and builds the line and word tables
+	void ProcessText(const FNTTGlyphTable& GlyphTable, const FString& InputText, const TArray<FVector2f>& CharacterPositionsUnfiltered, bool bFilterWhitespace, FNTTTextLayout& OutLayout)
+	{
+		OutLayout.LineStartIndices.Add(0);
+		OutLayout.GlyphIndices.Reserve(InputText.Len());
+		OutLayout.CharacterPositions.Reserve(InputText.Len());
+
+		FNTTTextIterator It(InputText);
+
+		bool bInsideWord = false;
+		int32 CurrentWordStartIndex = -1;
+		int32 CurrentWordCharCount = 0;
+
+		while (It.HasNextCharacter())
+		{
+			int32 SourceIndex = INDEX_NONE;
+			TCHAR Ch = 0;
+			while (It.NextCharacterInLine(SourceIndex, Ch))
+			{
+				const int32 Code = static_cast<int32>(Ch);
+				const bool bIsWhitespace = IsWhitespaceChar(Code);
+
+				if (bIsWhitespace)
+				{
+					if (bInsideWord)
+					{
+						bInsideWord = false;
+						OutLayout.WordStartIndices.Add(CurrentWordStartIndex);
+						OutLayout.WordCharacterCounts.Add(CurrentWordCharCount);
+					}
+				}
+				else
+				{
+					if (!bInsideWord)
+					{
+						bInsideWord = true;
+						CurrentWordStartIndex = OutLayout.GlyphIndices.Num();
+						CurrentWordCharCount = 0;
+					}
+					CurrentWordCharCount++;
+				}
+
+				if (bFilterWhitespace && bIsWhitespace)
+				{
+					continue;
+				}
+
+				OutLayout.GlyphIndices.Add(GlyphTable.FindGlyphIndex(static_cast<uint32>(Code)));
+				OutLayout.CharacterPositions.Add(CharacterPositionsUnfiltered[SourceIndex]);
+			}
+
+			if (It.HasNextCharacter())
+			{
+				if (bInsideWord)
+				{
+					bInsideWord = false;
+					OutLayout.WordStartIndices.Add(CurrentWordStartIndex);
+					OutLayout.WordCharacterCounts.Add(CurrentWordCharCount);
+				}
+				OutLayout.LineStartIndices.Add(OutLayout.GlyphIndices.Num());
+			}
+		}
+
+		if (bInsideWord)
+		{
+			OutLayout.WordStartIndices.Add(CurrentWordStartIndex);
+			OutLayout.WordCharacterCounts.Add(CurrentWordCharCount);
+		}
+
+		const int32 NumLines = OutLayout.LineStartIndices.Num();
+		OutLayout.LineCharacterCounts.Reserve(NumLines);
+		for (int32 LineIdx = 0; LineIdx < NumLines; ++LineIdx)
+		{
+			const int32 LineEnd = (LineIdx + 1 < NumLines) ? OutLayout.LineStartIndices[LineIdx + 1] : OutLayout.GlyphIndices.Num();
+			OutLayout.LineCharacterCounts.Add(LineEnd - OutLayout.LineStartIndices[LineIdx]);
+		}
+	}
+}
+
+namespace NTTTests
+{
+	void BuildLegacyLayout(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, const FString& Text, FNTTTextLayout& OutLayout)
+	{
+		using namespace NTTLegacyLayoutPrivate;
+
+		OutLayout = FNTTTextLayout();
+
+		float TotalTextHeight = 0.0f;
+		const TArray<FVector2f> CharacterPositionsUnfiltered = GetCharacterPositions(GlyphTable, Params, Text, TotalTextHeight);
+		if (CharacterPositionsUnfiltered.Num() == Text.Len())
+		{
+			ProcessText(GlyphTable, Text, CharacterPositionsUnfiltered, Params.bFilterWhitespaceCharacters, OutLayout);
+		}
+
+		OutLayout.bFilterWhitespaceCharactersValue = Params.bFilterWhitespaceCharacters;
+		OutLayout.TotalTextHeight = TotalTextHeight;
+	}
+}
@@ -0,0 +1,18 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FNTTGlyphTable;
+struct FNTTLayoutParams;
+struct FNTTTextLayout;
+
+namespace NTTTests
+{
+	// The layout pipeline the plugin used before FNTTTextLayoutEngine (GetCharacterPositions followed by ProcessText).
+	// Kept as the baseline of NiagaraTextToolkit.Benchmark.Layout and to check the engine against. It walks the text three
+	// times and allocates per-line arrays and an unfiltered position array the size of the text. Only fills what it used
+	// to fill: glyph indices, positions, line and word starts and counts, and the total height.
+	void BuildLegacyLayout(const FNTTGlyphTable& GlyphTable, const FNTTLayoutParams& Params, const FString& Text, FNTTTextLayout& OutLayout);
+}
@@ -0,0 +1,98 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTDiagnostics.h"
+#include "NiagaraTextToolkitHelpers.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NTTMinimalModeTestsPrivate
+{
+	// Spawns the test system with Text in a fresh world and returns the snapshot of its NTT instance
+	bool SpawnAndSnapshot(FAutomationTestBase& Test, UNiagaraSystem* System, const FString& Text, bool bCountsInMinimalMode, FNTTInstanceSnapshot& OutSnapshot)
+	{
+		NTTTests::FHeadlessWorld World;
+		UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World.Get(), System, FVector::ZeroVector, FRotator::ZeroRotator, FVector(1.0f), false, false, ENCPoolMethod::None, false);
+		UNTTDataInterface* DataInterface = Component ? UNiagaraTextToolkitHelpers::FindNTTDataInterface(Component->GetOverrideParameters()) : nullptr;
+		if (DataInterface == nullptr)
+		{
+			Test.AddError(TEXT("Could not spawn the test system"));
+			return false;
+		}
+
+		DataInterface->bCountsInMinimalMode = bCountsInMinimalMode;
+		UNiagaraTextToolkitHelpers::SetNiagaraNTTTextVariable(Component, Text);
+		Component->Activate();
+		World.Tick(2);
+
+		const TArray<FNTTInstanceSnapshot> Snapshots = FNTTInstanceRegistry::Get().Gather();
+		Component->DestroyComponent();
+		World.Tick();
+
+		if (Snapshots.Num() != 1)
+		{
+			Test.AddError(FString::Printf(TEXT("Expected one live NTT instance, found %d"), Snapshots.Num()));
+			return false;
+		}
+		OutSnapshot = Snapshots[0];
+		return true;
+	}
+}
+
+// Instances in minimal mode (dedicated servers, -nullrhi) skip the font and the render thread, and only keep counts when asked to
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTMinimalModeTest, "NiagaraTextToolkit.MinimalMode", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTMinimalModeTest::RunTest(const FString& Parameters)
+{
+	using namespace NTTMinimalModeTestsPrivate;
+
+	UNiagaraSystem* System = NTTTests::LoadTestSystem();
+	if (System == nullptr)
+	{
+		AddError(TEXT("Could not load the test system"));
+		return false;
+	}
+
+	NTTTests::FScopedCVar AsyncThreshold(TEXT("ntt.AsyncLayoutThreshold"), 0);
+	const FString Text = TEXT("Minimal mode\nkeeps the counts");
+
+	FNTTInstanceSnapshot Full;
+	{
+		NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), -1);
+		if (!SpawnAndSnapshot(*this, System, Text, false, Full))
+		{
+			return false;
+		}
+	}
+
+	FNTTInstanceSnapshot Empty;
+	FNTTInstanceSnapshot Counts;
+	{
+		NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), 1);
+		if (!SpawnAndSnapshot(*this, System, Text, false, Empty) || !SpawnAndSnapshot(*this, System, Text, true, Counts))
+		{
+			return false;
+		}
+	}
+
+	TestTrue(TEXT("Full mode lays out the text"), Full.NumCharacters > 0);
+	TestTrue(TEXT("Full mode uses the font"), Full.GlyphTableId != 0);
+
+	TestEqual(TEXT("Minimal mode without counts reports an empty text"), Empty.NumCharacters, 0);
+	TestEqual(TEXT("Minimal mode doesn't touch the font"), Empty.GlyphTableId, (uint32)0);
+	TestEqual(TEXT("Minimal mode has no GPU buffers"), (int64)Empty.GPUBytes, (int64)0);
+
+	TestEqual(TEXT("Counts in minimal mode match the full layout"), Counts.NumCharacters, Full.NumCharacters);
+	TestEqual(TEXT("Counts in minimal mode don't touch the font"), Counts.GlyphTableId, (uint32)0);
+	TestEqual(TEXT("Counts in minimal mode have no GPU buffers"), (int64)Counts.GPUBytes, (int64)0);
+	TestTrue(TEXT("A counts layout is smaller than the full one"), Counts.LayoutBytes < Full.LayoutBytes);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
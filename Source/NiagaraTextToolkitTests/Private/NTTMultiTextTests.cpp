@@ -0,0 +1,157 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTDiagnostics.h"
+#include "NTTLayoutCache.h"
+#include "NTTStats.h"
+#include "NTTTextLayout.h"
+#include "NiagaraTextToolkitHelpers.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NTTMultiTextTestsPrivate
+{
+	const FNTTInstanceSnapshot* GetOnlySnapshot(FAutomationTestBase& Test, TArray<FNTTInstanceSnapshot>& OutSnapshots)
+	{
+		OutSnapshots = FNTTInstanceRegistry::Get().Gather();
+		if (OutSnapshots.Num() != 1 || OutSnapshots[0].Layout == nullptr)
+		{
+			Test.AddError(TEXT("Expected one live NTT instance with a layout"));
+			return nullptr;
+		}
+		return &OutSnapshots[0];
+	}
+
+	const FNTTTextLayout* GetOnlyLayout(FAutomationTestBase& Test)
+	{
+		TArray<FNTTInstanceSnapshot> Snapshots;
+		const FNTTInstanceSnapshot* Snapshot = GetOnlySnapshot(Test, Snapshots);
+		return Snapshot ? static_cast<const FNTTTextLayout*>(Snapshot->Layout) : nullptr;
+	}
+
+	uint64 GetNumCacheLookups()
+	{
+		const FNTTLayoutCacheStats Stats = FNTTLayoutCache::Get().GetStats();
+		return Stats.Hits + Stats.Misses;
+	}
+}
+
+// Entries keep their layouts between updates: moving one only replaces the entry placements and keeps the layout, and
+// changing one text only lays out that entry again.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTMultiTextReusesEntryLayoutsTest, "NiagaraTextToolkit.MultiText.ReusesEntryLayouts", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTMultiTextReusesEntryLayoutsTest::RunTest(const FString& Parameters)
+{
+	using namespace NTTMultiTextTestsPrivate;
+
+	UNiagaraSystem* System = NTTTests::LoadTestSystem();
+	if (System == nullptr)
+	{
+		AddError(TEXT("Could not load the test system"));
+		return false;
+	}
+
+	NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), -1);
+
+	NTTTests::FHeadlessWorld World;
+	UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World.Get(), System, FVector::ZeroVector, FRotator::ZeroRotator, FVector(1.0f), false, false, ENCPoolMethod::None, false);
+	UNTTDataInterface* DataInterface = Component ? UNiagaraTextToolkitHelpers::FindNTTDataInterface(Component->GetOverrideParameters()) : nullptr;
+	if (DataInterface == nullptr)
+	{
+		AddError(TEXT("Could not spawn the test system"));
+		return false;
+	}
+
+	DataInterface->AddTextEntry(TEXT("First entry"), FVector(0.0, 0.0, 0.0));
+	const FNTTTextEntryHandle Moving = DataInterface->AddTextEntry(TEXT("Second entry\nwith two lines"), FVector(100.0, 0.0, 0.0));
+	DataInterface->AddTextEntry(TEXT("Third"), FVector(200.0, 0.0, 0.0));
+	Component->Activate();
+	World.Tick(2);
+
+	const FNTTTextLayout* Initial = GetOnlyLayout(*this);
+	if (Initial == nullptr)
+	{
+		return false;
+	}
+	const uint64 LookupsBefore = GetNumCacheLookups();
+	const int32 AllocationsBefore = NTTStats::GetNumInPlaceLayoutAllocations();
+	constexpr int32 NumFrames = 30;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		DataInterface->SetTextEntryOrigin(Moving, FVector(100.0, 10.0 * (Frame + 1), 0.0));
+		World.Tick();
+	}
+
+	TArray<FNTTInstanceSnapshot> Snapshots;
+	const FNTTInstanceSnapshot* Moved = GetOnlySnapshot(*this, Snapshots);
+	if (Moved == nullptr)
+	{
+		return false;
+	}
+	TestEqual(TEXT("Layout cache lookups while moving"), GetNumCacheLookups() - LookupsBefore, (uint64)0);
+	TestEqual(TEXT("Layouts allocated while moving"), NTTStats::GetNumInPlaceLayoutAllocations() - AllocationsBefore, 0);
+	TestTrue(TEXT("Layout kept while moving"), Moved->Layout == Initial);
+
+	const FNTTEntryPlacements* Placements = static_cast<const FNTTEntryPlacements*>(Moved->EntryPlacements);
+	if (TestNotNull(TEXT("Entry placements"), Placements) && TestEqual(TEXT("Entries"), Placements->Num(), 3))
+	{
+		TestTrue(TEXT("Moved origin"), Placements->EntryOrigins[1].Equals(FVector3f(100.0f, 10.0f * NumFrames, 0.0f)));
+		TestTrue(TEXT("Other origin"), Placements->EntryOrigins[2].Equals(FVector3f(200.0f, 0.0f, 0.0f)));
+	}
+
+	// Only the entry whose text changed goes back to the layout cache
+	const uint64 LookupsBeforeText = GetNumCacheLookups();
+	DataInterface->SetTextEntryText(Moving, TEXT("Changed"));
+	World.Tick();
+	TestEqual(TEXT("Layout cache lookups after a text change"), GetNumCacheLookups() - LookupsBeforeText, (uint64)1);
+
+	const FNTTTextLayout* Changed = GetOnlyLayout(*this);
+	if (Changed != nullptr && TestEqual(TEXT("Entries after a text change"), Changed->NumEntries(), 3))
+	{
+		TestEqual(TEXT("Changed entry characters"), Changed->EntryCharacterCounts[1], 7);
+		TestEqual(TEXT("Characters"), Changed->NumCharacters(), Changed->EntryCharacterCounts[0] + 7 + Changed->EntryCharacterCounts[2]);
+	}
+
+	Component->DestroyComponent();
+	World.Tick();
+	return true;
+}
+
+// Setting a text leaves multi-text mode, and data interfaces with different entries are never merged by Equals
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTMultiTextModeChangesTest, "NiagaraTextToolkit.MultiText.ModeChanges", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTMultiTextModeChangesTest::RunTest(const FString& Parameters)
+{
+	UNTTDataInterface* DataInterface = NewObject<UNTTDataInterface>();
+	const FNTTTextEntryHandle Entry = DataInterface->AddTextEntry(TEXT("Entry"), FVector::ZeroVector);
+	TestTrue(TEXT("Multi-text after AddTextEntry"), DataInterface->GetLayoutParams().bMultiText);
+
+	UNTTDataInterface* Copy = NewObject<UNTTDataInterface>();
+	DataInterface->CopyTo(Copy);
+	TestTrue(TEXT("Copy equals"), DataInterface->Equals(Copy));
+
+	Copy->SetTextEntryOrigin(Entry, FVector(10.0, 0.0, 0.0));
+	TestFalse(TEXT("Moved entry differs"), DataInterface->Equals(Copy));
+	Copy->SetTextEntryOrigin(Entry, FVector::ZeroVector);
+	Copy->SetTextEntryText(Entry, TEXT("Other"));
+	TestFalse(TEXT("Entry text differs"), DataInterface->Equals(Copy));
+	Copy->RemoveTextEntry(Entry);
+	TestFalse(TEXT("Missing entry differs"), DataInterface->Equals(Copy));
+
+	DataInterface->SetInputText(TEXT("Hello"));
+	const FNTTLayoutParams Params = DataInterface->GetLayoutParams();
+	TestFalse(TEXT("Multi-text left"), Params.bMultiText);
+	TestEqual(TEXT("Text shown"), Params.InputText, FString(TEXT("Hello")));
+	TestEqual(TEXT("Entries kept"), DataInterface->GetNumTextEntries(), 1);
+
+	DataInterface->AddTextEntry(TEXT("Back"), FVector::ZeroVector);
+	TestTrue(TEXT("Multi-text after the next AddTextEntry"), DataInterface->GetLayoutParams().bMultiText);
+	return true;
+}
+
+#endif
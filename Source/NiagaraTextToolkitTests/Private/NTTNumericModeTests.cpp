@@ -0,0 +1,140 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTDiagnostics.h"
+#include "NTTStats.h"
+#include "NTTTextLayout.h"
+#include "NiagaraTextToolkitHelpers.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// A counter updated every frame rebuilds into the layouts its instance already owns. The test system runs on the CPU, so the
+// render thread keeps the last layout it received instead of uploading and releasing it.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTNumericModeReusesLayoutsTest, "NiagaraTextToolkit.NumericMode.ReusesLayouts", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTNumericModeReusesLayoutsTest::RunTest(const FString& Parameters)
+{
+	UNiagaraSystem* System = NTTTests::LoadTestSystem();
+	if (System == nullptr)
+	{
+		AddError(TEXT("Could not load the test system"));
+		return false;
+	}
+
+	NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), -1);
+	NTTTests::FScopedCVar AsyncThreshold(TEXT("ntt.AsyncLayoutThreshold"), 0);
+
+	NTTTests::FHeadlessWorld World;
+	UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World.Get(), System, FVector::ZeroVector, FRotator::ZeroRotator, FVector(1.0f), false, false, ENCPoolMethod::None, false);
+	UNTTDataInterface* DataInterface = Component ? UNiagaraTextToolkitHelpers::FindNTTDataInterface(Component->GetOverrideParameters()) : nullptr;
+	if (DataInterface == nullptr)
+	{
+		AddError(TEXT("Could not spawn the test system"));
+		return false;
+	}
+
+	// Same number of digits every frame, so reused layouts never need to grow
+	DataInterface->SetNumericValue(1000.0);
+	Component->Activate();
+
+	constexpr int32 NumWarmUpFrames = 8;
+	constexpr int32 NumFrames = 120;
+	for (int32 Frame = 0; Frame < NumWarmUpFrames; ++Frame)
+	{
+		DataInterface->SetNumericValue(1001.0 + Frame);
+		World.Tick();
+	}
+
+	const int32 AllocationsBefore = NTTStats::GetNumInPlaceLayoutAllocations();
+	TSet<const void*> Layouts;
+	TSet<const void*> GlyphArrays;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		DataInterface->SetNumericValue(2000.0 + Frame * 37);
+		World.Tick();
+
+		// Gather flushes the render thread, so sample sparsely to keep it a frame behind most of the time
+		if (Frame % 10 == 9)
+		{
+			const TArray<FNTTInstanceSnapshot> Snapshots = FNTTInstanceRegistry::Get().Gather();
+			if (Snapshots.Num() != 1 || Snapshots[0].Layout == nullptr)
+			{
+				AddError(TEXT("Expected one live NTT instance with a layout"));
+				break;
+			}
+
+			const FNTTTextLayout* Layout = static_cast<const FNTTTextLayout*>(Snapshots[0].Layout);
+			TestEqual(TEXT("Characters"), Snapshots[0].NumCharacters, 4);
+			Layouts.Add(Layout);
+			GlyphArrays.Add(Layout->GlyphIndices.GetData());
+		}
+	}
+	const int32 Allocations = NTTStats::GetNumInPlaceLayoutAllocations() - AllocationsBefore;
+
+	Component->DestroyComponent();
+	World.Tick();
+
+	TestEqual(TEXT("Layouts allocated after warm-up"), Allocations, 0);
+	TestTrue(TEXT("Layouts are rotated, not replaced"), Layouts.Num() <= 1 + FNDIFontUVInfoInstanceData::MaxRetiredLayouts);
+	TestTrue(TEXT("Per-character arrays are reused"), GlyphArrays.Num() <= 1 + FNDIFontUVInfoInstanceData::MaxRetiredLayouts);
+	return true;
+}
+
+// A text set after a number replaces it, on a DI that isn't running and on one reused by a running system
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTNumericModeTextAfterNumberTest, "NiagaraTextToolkit.NumericMode.TextAfterNumber", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTNumericModeTextAfterNumberTest::RunTest(const FString& Parameters)
+{
+	UNTTDataInterface* Unused = NewObject<UNTTDataInterface>();
+	Unused->SetNumericValue(42.0);
+	TestEqual(TEXT("Number shown"), Unused->GetLayoutParams().InputText, FString(TEXT("42")));
+
+	const uint32 RevisionBefore = Unused->GetLayoutParams().Revision;
+	Unused->SetInputText(TEXT("Hello"));
+	const FNTTLayoutParams Params = Unused->GetLayoutParams();
+	TestFalse(TEXT("Numeric mode left"), Unused->bNumericMode);
+	TestEqual(TEXT("Text shown"), Params.InputText, FString(TEXT("Hello")));
+	TestNotEqual(TEXT("Revision bumped"), Params.Revision, RevisionBefore);
+
+	UNiagaraSystem* System = NTTTests::LoadTestSystem();
+	if (System == nullptr)
+	{
+		AddError(TEXT("Could not load the test system"));
+		return false;
+	}
+
+	NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), -1);
+
+	NTTTests::FHeadlessWorld World;
+	UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World.Get(), System, FVector::ZeroVector, FRotator::ZeroRotator, FVector(1.0f), false, false, ENCPoolMethod::None, false);
+	UNTTDataInterface* DataInterface = Component ? UNiagaraTextToolkitHelpers::FindNTTDataInterface(Component->GetOverrideParameters()) : nullptr;
+	if (DataInterface == nullptr)
+	{
+		AddError(TEXT("Could not spawn the test system"));
+		return false;
+	}
+
+	DataInterface->SetNumericValue(1234.0);
+	Component->Activate();
+	World.Tick(2);
+
+	DataInterface->SetInputText(TEXT("Hello"));
+	World.Tick();
+
+	const TArray<FNTTInstanceSnapshot> Snapshots = FNTTInstanceRegistry::Get().Gather();
+	if (TestEqual(TEXT("Live instances"), Snapshots.Num(), 1))
+	{
+		TestEqual(TEXT("Characters of the text"), Snapshots[0].NumCharacters, 5);
+	}
+
+	Component->DestroyComponent();
+	World.Tick();
+	return true;
+}
+
+#endif
@@ -0,0 +1,176 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTPackedEncoding.h"
+#include "NTTTextLayout.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTPackedEncodingRoundTripTest, "NiagaraTextToolkit.Encoding.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTPackedEncodingRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace NTTPackedEncoding;
+
+	// Packed ints, including INDEX_NONE and the largest packable value
+	const TArray<int32> Ints = { 0, 1, INDEX_NONE, 1234, MaxPacked16Value, 7, 65000 };
+	TestTrue(TEXT("Values up to MaxPacked16Value can be packed"), CanPack16(Ints));
+	TestFalse(TEXT("0xFFFF can't be packed, it stands for INDEX_NONE"), CanPack16(TArray<int32>{ 0xFFFF }));
+	TestFalse(TEXT("Values below INDEX_NONE can't be packed"), CanPack16(TArray<int32>{ -2 }));
+
+	for (const bool bPacked16 : { false, true })
+	{
+		// Odd count, so the last slot is half used
+		TArray<float> Slots;
+		Slots.SetNumZeroed(GetIntSlots(Ints.Num(), bPacked16));
+		WriteInts(Slots.GetData(), Ints, bPacked16);
+		for (int32 Index = 0; Index < Ints.Num(); ++Index)
+		{
+			TestEqual(FString::Printf(TEXT("Int %d (packed: %d)"), Index, (int32)bPacked16), ReadInt(Slots.GetData(), Index, bPacked16), Ints[Index]);
+		}
+	}
+
+	// Half positions are only chosen when they are exact, so they must come back bit for bit
+	const TArray<FVector2f> ExactPositions = { FVector2f(0.0f, 0.0f), FVector2f(-12.5f, 48.0f), FVector2f(1024.0f, -0.25f), FVector2f(2047.0f, 3.75f) };
+	TestTrue(TEXT("Pixel and quarter pixel positions are exact in half precision"), CanPackHalfExact(ExactPositions));
+	TestFalse(TEXT("0.1 isn't exact in half precision"), CanPackHalfExact(TArray<FVector2f>{ FVector2f(0.1f, 0.0f) }));
+	TestFalse(TEXT("Odd values above 2048 aren't exact in half precision"), CanPackHalfExact(TArray<FVector2f>{ FVector2f(4097.0f, 0.0f) }));
+
+	for (const bool bHalf : { false, true })
+	{
+		TArray<float> Slots;
+		Slots.SetNumZeroed(GetPositionSlots(ExactPositions.Num(), bHalf));
+		WritePositions(Slots.GetData(), ExactPositions, bHalf);
+		for (int32 Index = 0; Index < ExactPositions.Num(); ++Index)
+		{
+			TestTrue(FString::Printf(TEXT("Position %d (half: %d)"), Index, (int32)bHalf), ReadPosition(Slots.GetData(), Index, bHalf) == ExactPositions[Index]);
+		}
+	}
+
+	// Glyph UVs are normalized, compact ones are within one unorm16 step
+	const TArray<FVector4f> UVs = { FVector4f(0.0f, 1.0f, 0.5f, 0.25f), FVector4f(0.0123f, 0.0456f, 0.789f, 0.999f) };
+	for (const bool bCompact : { false, true })
+	{
+		TArray<float> Slots;
+		Slots.SetNumZeroed(GetGlyphUVSlots(UVs.Num(), bCompact));
+		WriteGlyphUVs(Slots.GetData(), UVs, bCompact);
+		const float Tolerance = bCompact ? 0.5f / 65535.0f + KINDA_SMALL_NUMBER : 0.0f;
+		for (int32 Index = 0; Index < UVs.Num(); ++Index)
+		{
+			const FVector4f Decoded = ReadGlyphUV(Slots.GetData(), Index, bCompact);
+			TestTrue(FString::Printf(TEXT("Glyph UV %d (compact: %d)"), Index, (int32)bCompact), Decoded.Equals(UVs[Index], Tolerance));
+		}
+	}
+
+	// Every encoding chosen for a real layout must be lossless
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	FNTTTextLayout Layout;
+	FNTTTextLayoutEngine::Build(*GlyphTable, FNTTLayoutParams(), NTTTests::MakeText(5000, 60), Layout);
+
+	NTTTests::FScopedCVar CompactEncoding(TEXT("ntt.CompactGPUEncoding"), 1);
+	const ENTTTextEncoding Encoding = ChooseTextEncoding(Layout);
+	TestTrue(TEXT("A short text uses 16-bit tables"), EnumHasAllFlags(Encoding, ENTTTextEncoding::GlyphIndices16 | ENTTTextEncoding::CharacterIndices16 | ENTTTextEncoding::Tables16));
+
+	auto TestIntTable = [this](const TCHAR* Name, const TArray<int32>& Values, bool bPacked16)
+	{
+		TArray<float> Slots;
+		Slots.SetNumZeroed(GetIntSlots(Values.Num(), bPacked16));
+		WriteInts(Slots.GetData(), Values, bPacked16);
+		for (int32 Index = 0; Index < Values.Num(); ++Index)
+		{
+			if (ReadInt(Slots.GetData(), Index, bPacked16) != Values[Index])
+			{
+				AddError(FString::Printf(TEXT("%s: element %d doesn't survive the round trip"), Name, Index));
+				return;
+			}
+		}
+	};
+
+	TestIntTable(TEXT("GlyphIndices"), Layout.GlyphIndices, EnumHasAnyFlags(Encoding, ENTTTextEncoding::GlyphIndices16));
+	TestIntTable(TEXT("CharacterLineIndices"), Layout.CharacterLineIndices, EnumHasAnyFlags(Encoding, ENTTTextEncoding::CharacterIndices16));
+	TestIntTable(TEXT("CharacterWordIndices"), Layout.CharacterWordIndices, EnumHasAnyFlags(Encoding, ENTTTextEncoding::CharacterIndices16));
+	TestIntTable(TEXT("LineStartIndices"), Layout.LineStartIndices, EnumHasAnyFlags(Encoding, ENTTTextEncoding::Tables16));
+	TestIntTable(TEXT("WordCharacterCountPrefix"), Layout.WordCharacterCountPrefix, EnumHasAnyFlags(Encoding, ENTTTextEncoding::Tables16));
+
+	const bool bHalfPositions = EnumHasAnyFlags(Encoding, ENTTTextEncoding::PositionsHalf);
+	TArray<float> PositionSlots;
+	PositionSlots.SetNumZeroed(GetPositionSlots(Layout.NumCharacters(), bHalfPositions));
+	WritePositions(PositionSlots.GetData(), Layout.CharacterPositions, bHalfPositions);
+	for (int32 Index = 0; Index < Layout.NumCharacters(); ++Index)
+	{
+		if (ReadPosition(PositionSlots.GetData(), Index, bHalfPositions) != Layout.CharacterPositions[Index])
+		{
+			AddError(FString::Printf(TEXT("CharacterPositions: element %d doesn't survive the round trip"), Index));
+			break;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTCharacterRecordsTest, "NiagaraTextToolkit.Encoding.CharacterRecords", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTCharacterRecordsTest::RunTest(const FString& Parameters)
+{
+	using namespace NTTPackedEncoding;
+
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	// Unfiltered, so whitespace before the first word has INDEX_NONE as its word, and a character the font has no glyph for
+	FNTTLayoutParams Params;
+	Params.bFilterWhitespaceCharacters = false;
+	FNTTTextLayout Layout;
+	FNTTTextLayoutEngine::Build(*GlyphTable, Params, TEXT("  ") + NTTTests::MakeText(5000, 60) + TEXT("\u4E2D"), Layout);
+
+	TArray<FUintVector4> Records;
+	TestTrue(TEXT("A short text fits records"), BuildCharacterRecords(Layout, Records));
+	TestEqual(TEXT("One record per character"), Records.Num(), Layout.NumCharacters());
+
+	for (int32 Index = 0; Index < Records.Num(); ++Index)
+	{
+		FVector2f Position;
+		int32 GlyphIndex;
+		int32 LineIndex;
+		int32 WordIndex;
+		ReadCharacterRecord(Records[Index], Position, GlyphIndex, LineIndex, WordIndex);
+
+		if (FMemory::Memcmp(&Position, &Layout.CharacterPositions[Index], sizeof(FVector2f)) != 0
+			|| GlyphIndex != Layout.GlyphIndices[Index]
+			|| LineIndex != Layout.CharacterLineIndices[Index]
+			|| WordIndex != Layout.CharacterWordIndices[Index])
+		{
+			AddError(FString::Printf(TEXT("Record %d doesn't match the layout"), Index));
+			break;
+		}
+	}
+
+	// Too many lines for a 16-bit line index
+	FNTTTextLayout TallLayout;
+	TallLayout.GlyphIndices.Add(0);
+	TallLayout.CharacterPositions.Add(FVector2f::ZeroVector);
+	TallLayout.CharacterLineIndices.Add(0);
+	TallLayout.CharacterWordIndices.Add(0);
+	TallLayout.LineStartIndices.SetNumZeroed(MaxPacked16Value + 1);
+	TallLayout.LineCharacterCounts.SetNumZeroed(MaxPacked16Value + 1);
+
+	TestFalse(TEXT("Layouts with more than MaxPacked16Value lines don't fit records"), CanBuildCharacterRecords(TallLayout));
+	TestFalse(TEXT("Building records for them fails"), BuildCharacterRecords(TallLayout, Records));
+	TestEqual(TEXT("and leaves no records"), Records.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,85 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTTextLayout.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Every window lays out exactly its lines, including empty lines at its edges, so scrolling never changes how many lines
+// are shown or how tall the block is
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTStreamingModeWindowsTest, "NiagaraTextToolkit.StreamingMode.Windows", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNTTStreamingModeWindowsTest::RunTest(const FString& Parameters)
+{
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	const TArray<FString> Lines = { TEXT("Title"), TEXT(""), TEXT(""), TEXT("Line three"), TEXT("Line four"), TEXT(""), TEXT(""), TEXT("Line seven"), TEXT(""), TEXT("Line nine") };
+	// CRLF and CR line breaks are indexed like the layout engine reads them
+	FString Document;
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		Document += Lines[LineIndex];
+		if (LineIndex + 1 < Lines.Num())
+		{
+			Document += (LineIndex == 7) ? TEXT("\r\n") : (LineIndex == 3) ? TEXT("\r") : TEXT("\n");
+		}
+	}
+
+	UNTTDataInterface* DataInterface = NewObject<UNTTDataInterface>();
+	DataInterface->SetInputText(Document);
+	DataInterface->bStreamingMode = true;
+	DataInterface->StreamingWindowLines = 3;
+	DataInterface->MarkLayoutDirty();
+	TestEqual(TEXT("Document lines"), DataInterface->GetDocumentLineCount(), Lines.Num());
+
+	FString WindowText;
+	const TCHAR* WindowTextData = nullptr;
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		for (int32 ScrollLine = 0; ScrollLine < Lines.Num(); ++ScrollLine)
+		{
+			DataInterface->SetStreamingScrollLine(ScrollLine);
+			const int32 NumWindowLines = FMath::Min(3, Lines.Num() - ScrollLine);
+			const FString Expected = FString::Join(TArrayView<const FString>(Lines).Slice(ScrollLine, NumWindowLines), TEXT("\n"));
+
+			FNTTLayoutParams Params = DataInterface->GetLayoutParams(nullptr, &WindowText);
+			if (!TestTrue(TEXT("Window copied into the caller's buffer"), Params.bWindowText && Params.bStreaming))
+			{
+				return false;
+			}
+			TestEqual(TEXT("Window first line"), Params.WindowFirstLine, ScrollLine);
+
+			FNTTTextLayout Window;
+			FNTTTextLayout Reference;
+			FNTTTextLayoutEngine::Build(*GlyphTable, Params, WindowText, Window);
+			FNTTTextLayoutEngine::Build(*GlyphTable, Params, Expected, Reference);
+
+			const FString What = FString::Printf(TEXT("Window at line %d"), ScrollLine);
+			TestEqual(What + TEXT(": lines"), Window.NumLines(), NumWindowLines);
+			TestEqual(What + TEXT(": characters"), Window.NumCharacters(), Reference.NumCharacters());
+			TestEqual(What + TEXT(": height"), Window.TotalTextHeight, Reference.TotalTextHeight);
+			TestTrue(What + TEXT(": positions"), Window.CharacterPositions == Reference.CharacterPositions);
+
+			// The copy without a buffer holds the same text
+			TestEqual(What + TEXT(": InputText"), DataInterface->GetLayoutParams().InputText, FString(WindowText));
+
+			// Once the buffer has grown to the longest window, scrolling doesn't reallocate it
+			if (Pass == 1)
+			{
+				TestTrue(What + TEXT(": buffer reused"), WindowText.GetCharArray().GetData() == WindowTextData);
+			}
+		}
+		WindowTextData = WindowText.GetCharArray().GetData();
+	}
+
+	return true;
+}
+
+#endif
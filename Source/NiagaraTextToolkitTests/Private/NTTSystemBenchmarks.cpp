@@ -0,0 +1,145 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDiagnostics.h"
+#include "NiagaraTextToolkitHelpers.h"
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NTTSystemBenchmarksPrivate
+{
+	// Sets the text before activating, so the system spawns its particles for that text
+	UNiagaraComponent* SpawnTextSystem(UWorld* World, UNiagaraSystem* System, const FString& Text)
+	{
+		UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World, System, FVector::ZeroVector, FRotator::ZeroRotator, FVector(1.0f), false, false, ENCPoolMethod::None, false);
+		if (Component)
+		{
+			UNiagaraTextToolkitHelpers::SetNiagaraNTTTextVariable(Component, Text);
+			Component->Activate();
+		}
+		return Component;
+	}
+}
+
+// Cost of a CPU simulated text system per frame for texts of 64 to 64k characters. The template spawns one particle per
+// character left after whitespace filtering and calls the NTT VM functions for each of them. Rows report that particle
+// count rather than the text length.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTSystemTickBenchmark, "NiagaraTextToolkit.Benchmark.SystemTick", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNTTSystemTickBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace NTTSystemBenchmarksPrivate;
+
+	UNiagaraSystem* System = NTTTests::LoadTestSystem();
+	if (System == nullptr)
+	{
+		AddError(TEXT("Could not load the test system"));
+		return false;
+	}
+
+	// Lay out inline so the first frame already has every character. Tests usually run without rendering,
+	// which would otherwise put every instance in minimal mode.
+	NTTTests::FScopedCVar AsyncThreshold(TEXT("ntt.AsyncLayoutThreshold"), 0);
+	NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), -1);
+	NTTTests::FBenchmarkCsv Csv(TEXT("SystemTick"), TEXT("Characters,Frames,MsPerFrame,NsPerCharacter"));
+
+	for (const int32 NumChars : { 64, 1024, 65536 })
+	{
+		NTTTests::FHeadlessWorld World;
+		UNiagaraComponent* Component = SpawnTextSystem(World.Get(), System, NTTTests::MakeText(NumChars));
+		if (Component == nullptr || !Component->IsActive())
+		{
+			AddError(FString::Printf(TEXT("Could not activate the test system with %d characters"), NumChars));
+			continue;
+		}
+
+		// Let the system spawn its particles before measuring
+		World.Tick(10);
+
+		// Whitespace is filtered out, so the system has fewer particles than the text has characters
+		const TArray<FNTTInstanceSnapshot> Snapshots = FNTTInstanceRegistry::Get().Gather();
+		const int32 NumParticles = (Snapshots.Num() == 1) ? Snapshots[0].NumCharacters : 0;
+		if (NumParticles <= 0)
+		{
+			AddError(FString::Printf(TEXT("The test system has no characters for a %d character text"), NumChars));
+			Component->DestroyComponent();
+			continue;
+		}
+
+		constexpr int32 NumFrames = 60;
+		const double StartTime = FPlatformTime::Seconds();
+		World.Tick(NumFrames);
+		const double SecondsPerFrame = (FPlatformTime::Seconds() - StartTime) / NumFrames;
+
+		const FString Row = FString::Printf(TEXT("%d,%d,%.4f,%.2f"), NumParticles, NumFrames, SecondsPerFrame * 1000.0, SecondsPerFrame / NumParticles * 1000000000.0);
+		AddInfo(Row);
+		Csv.AddRow(Row);
+
+		Component->DestroyComponent();
+	}
+
+	TestTrue(TEXT("Results written to ") + Csv.GetPath(), Csv.Write());
+	return true;
+}
+
+// Spawning, activating and destroying many text systems in one frame: InitPerInstanceData, layout and
+// DestroyPerInstanceData churn, the way a big fight spawns damage numbers.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTSpawnDestroyBenchmark, "NiagaraTextToolkit.Benchmark.SpawnDestroy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNTTSpawnDestroyBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace NTTSystemBenchmarksPrivate;
+
+	UNiagaraSystem* System = NTTTests::LoadTestSystem();
+	if (System == nullptr)
+	{
+		AddError(TEXT("Could not load the test system"));
+		return false;
+	}
+
+	NTTTests::FScopedCVar MinimalMode(TEXT("ntt.MinimalMode"), -1);
+	NTTTests::FBenchmarkCsv Csv(TEXT("SpawnDestroy"), TEXT("Systems,SpawnMs,FirstTickMs,DestroyMs,UsPerSystem"));
+
+	for (const int32 NumSystems : { 1, 10, 100, 500 })
+	{
+		NTTTests::FHeadlessWorld World;
+		TArray<UNiagaraComponent*> Components;
+		Components.Reserve(NumSystems);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 SystemIdx = 0; SystemIdx < NumSystems; ++SystemIdx)
+		{
+			Components.Add(SpawnTextSystem(World.Get(), System, FString::Printf(TEXT("%d"), 100 + SystemIdx * 7)));
+		}
+		const double SpawnSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		World.Tick();
+		const double FirstTickSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (UNiagaraComponent* Component : Components)
+		{
+			if (Component)
+			{
+				Component->DestroyComponent();
+			}
+		}
+		World.Tick();
+		const double DestroySeconds = FPlatformTime::Seconds() - StartTime;
+
+		const double TotalSeconds = SpawnSeconds + FirstTickSeconds + DestroySeconds;
+		const FString Row = FString::Printf(TEXT("%d,%.4f,%.4f,%.4f,%.2f"), NumSystems, SpawnSeconds * 1000.0, FirstTickSeconds * 1000.0, DestroySeconds * 1000.0, TotalSeconds / NumSystems * 1000000.0);
+		AddInfo(Row);
+		Csv.AddRow(Row);
+	}
+
+	TestTrue(TEXT("Results written to ") + Csv.GetPath(), Csv.Write());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,169 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTTextLayout.h"
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NiagaraSystem.h"
+#include "RenderingThread.h"
+
+namespace NTTTests
+{
+	UFont* LoadTestFont()
+	{
+		return LoadObject<UFont>(nullptr, TEXT("/NiagaraTextToolkit/ThirdParty/Fonts/Roboto/F_NTT_Roboto.F_NTT_Roboto"));
+	}
+
+	UNiagaraSystem* LoadTestSystem()
+	{
+		return LoadObject<UNiagaraSystem>(nullptr, TEXT("/NiagaraTextToolkit/Niagara/Systems/NS_NTT_Template.NS_NTT_Template"));
+	}
+
+	FNTTGlyphTableRef LoadTestGlyphTable()
+	{
+		FNTTGlyphTableRef GlyphTable = FNTTFontGlyphCache::Get().FindOrBuild(LoadTestFont());
+		return (GlyphTable.IsValid() && GlyphTable->IsValid()) ? GlyphTable : nullptr;
+	}
+
+	FString MakeText(int32 NumChars, int32 CharsPerLine, uint32 Seed)
+	{
+		FRandomStream Random(static_cast<int32>(Seed));
+		FString Text;
+		Text.Reserve(NumChars);
+
+		int32 LineLength = 0;
+		while (Text.Len() < NumChars)
+		{
+			const int32 WordLength = Random.RandRange(2, 9);
+			for (int32 CharIdx = 0; CharIdx < WordLength && Text.Len() < NumChars; ++CharIdx)
+			{
+				Text.AppendChar(static_cast<TCHAR>((CharIdx == 0 && Random.FRand() < 0.2f ? 'A' : 'a') + Random.RandRange(0, 25)));
+				++LineLength;
+			}
+
+			if (Text.Len() < NumChars)
+			{
+				const bool bLineBreak = LineLength >= CharsPerLine;
+				Text.AppendChar(bLineBreak ? TEXT('\n') : TEXT(' '));
+				LineLength = bLineBreak ? 0 : LineLength + 1;
+			}
+		}
+		return Text;
+	}
+
+	template<typename T>
+	static bool AreArraysIdentical(const TArray<T>& A, const TArray<T>& B, const TCHAR* TableName, FString& OutDifference)
+	{
+		if (A.Num() != B.Num())
+		{
+			OutDifference = FString::Printf(TEXT("%s: %d vs %d elements"), TableName, A.Num(), B.Num());
+			return false;
+		}
+		for (int32 Index = 0; Index < A.Num(); ++Index)
+		{
+			if (FMemory::Memcmp(&A[Index], &B[Index], sizeof(T)) != 0)
+			{
+				OutDifference = FString::Printf(TEXT("%s: first difference at element %d"), TableName, Index);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool AreLayoutsIdentical(const FNTTTextLayout& A, const FNTTTextLayout& B, FString& OutDifference)
+	{
+		if (FMemory::Memcmp(&A.TotalTextHeight, &B.TotalTextHeight, sizeof(float)) != 0)
+		{
+			OutDifference = FString::Printf(TEXT("TotalTextHeight: %f vs %f"), A.TotalTextHeight, B.TotalTextHeight);
+			return false;
+		}
+
+		return AreArraysIdentical(A.GlyphIndices, B.GlyphIndices, TEXT("GlyphIndices"), OutDifference)
+			&& AreArraysIdentical(A.CharacterPositions, B.CharacterPositions, TEXT("CharacterPositions"), OutDifference)
+			&& AreArraysIdentical(A.CharacterLineIndices, B.CharacterLineIndices, TEXT("CharacterLineIndices"), OutDifference)
+			&& AreArraysIdentical(A.CharacterWordIndices, B.CharacterWordIndices, TEXT("CharacterWordIndices"), OutDifference)
+			&& AreArraysIdentical(A.LineStartIndices, B.LineStartIndices, TEXT("LineStartIndices"), OutDifference)
+			&& AreArraysIdentical(A.LineCharacterCounts, B.LineCharacterCounts, TEXT("LineCharacterCounts"), OutDifference)
+			&& AreArraysIdentical(A.WordStartIndices, B.WordStartIndices, TEXT("WordStartIndices"), OutDifference)
+			&& AreArraysIdentical(A.WordCharacterCounts, B.WordCharacterCounts, TEXT("WordCharacterCounts"), OutDifference)
+			&& AreArraysIdentical(A.WordCharacterCountPrefix, B.WordCharacterCountPrefix, TEXT("WordCharacterCountPrefix"), OutDifference)
+			&& AreArraysIdentical(A.WordWithTrailingWhitespacePrefix, B.WordWithTrailingWhitespacePrefix, TEXT("WordWithTrailingWhitespacePrefix"), OutDifference)
+			&& AreArraysIdentical(A.LineCharacterCountPrefix, B.LineCharacterCountPrefix, TEXT("LineCharacterCountPrefix"), OutDifference);
+	}
+
+	FBenchmarkCsv::FBenchmarkCsv(const FString& InName, const FString& InColumns)
+		: Name(InName)
+		, Columns(InColumns)
+	{
+		RunTag = FString::Printf(TEXT("%s,%s"), *FDateTime::UtcNow().ToIso8601(), LexToString(FApp::GetBuildConfiguration()));
+	}
+
+	void FBenchmarkCsv::AddRow(const FString& Values)
+	{
+		Rows.Add(FString::Printf(TEXT("%s,%s"), *RunTag, *Values));
+	}
+
+	FString FBenchmarkCsv::GetPath() const
+	{
+		return FPaths::ProjectSavedDir() / TEXT("NiagaraTextToolkit") / TEXT("Benchmarks") / (Name + TEXT(".csv"));
+	}
+
+	bool FBenchmarkCsv::Write() const
+	{
+		const FString Path = GetPath();
+
+		FString Contents;
+		if (!FPaths::FileExists(Path))
+		{
+			Contents = FString::Printf(TEXT("Time,Configuration,%s\n"), *Columns);
+		}
+		for (const FString& Row : Rows)
+		{
+			Contents += Row;
+			Contents += TEXT("\n");
+		}
+
+		return FFileHelper::SaveStringToFile(Contents, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+	}
+
+	FHeadlessWorld::FHeadlessWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("NTTTestWorld"));
+		World->AddToRoot();
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	FHeadlessWorld::~FHeadlessWorld()
+	{
+		FlushRenderingCommands();
+
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+		World = nullptr;
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	void FHeadlessWorld::Tick(int32 NumFrames, float DeltaSeconds)
+	{
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaSeconds);
+			// Tests run inside one engine frame, so the end of frame flush never comes. Sends the render thread removals of
+			// instances destroyed during this frame without ending the frame for the rest of the engine.
+			FNTTInstanceRemovalQueue::Get().Flush();
+		}
+	}
+}
@@ -0,0 +1,109 @@
+// Property of Lucian Tranc
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "NTTFontGlyphCache.h"
+
+class UFont;
+class UNiagaraSystem;
+class UWorld;
+struct FNTTTextLayout;
+
+namespace NTTTests
+{
+	// Offline font and CPU system shipped with the plugin, so tests don't depend on project content
+	UFont* LoadTestFont();
+	UNiagaraSystem* LoadTestSystem();
+
+	// Glyph table of the test font, null if the font couldn't be loaded
+	FNTTGlyphTableRef LoadTestGlyphTable();
+
+	// Deterministic text of exactly NumChars characters: words of 2-9 letters separated by spaces,
+	// with a line break roughly every CharsPerLine characters.
+	FString MakeText(int32 NumChars, int32 CharsPerLine = 80, uint32 Seed = 0);
+
+	// Compares every table of two layouts bit for bit. Returns false and describes the first difference otherwise.
+	bool AreLayoutsIdentical(const FNTTTextLayout& A, const FNTTTextLayout& B, FString& OutDifference);
+
+	// Sets a console variable for the lifetime of the scope
+	class FScopedCVar
+	{
+	public:
+		FScopedCVar(const TCHAR* Name, int32 Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			if (Variable)
+			{
+				PreviousValue = Variable->GetInt();
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedCVar()
+		{
+			if (Variable)
+			{
+				Variable->Set(PreviousValue, ECVF_SetByCode);
+			}
+		}
+
+	private:
+		IConsoleVariable* Variable = nullptr;
+		int32 PreviousValue = 0;
+	};
+
+	// Calls Func until MinSeconds have passed and it ran at least MinIterations times. Returns the average seconds per call.
+	template<typename FuncType>
+	double TimeIterations(FuncType&& Func, int32& OutIterations, double MinSeconds = 0.25, int32 MinIterations = 3)
+	{
+		OutIterations = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		double Elapsed = 0.0;
+		while (OutIterations < MinIterations || Elapsed < MinSeconds)
+		{
+			Func();
+			++OutIterations;
+			Elapsed = FPlatformTime::Seconds() - StartTime;
+		}
+		return Elapsed / OutIterations;
+	}
+
+	// Benchmark results, appended to Saved/NiagaraTextToolkit/Benchmarks/<Name>.csv.
+	// Every row starts with the time of the run and the build configuration so results can be tracked over time.
+	class FBenchmarkCsv
+	{
+	public:
+		FBenchmarkCsv(const FString& InName, const FString& InColumns);
+
+		void AddRow(const FString& Values);
+
+		// Writes the header first if the file doesn't exist yet
+		bool Write() const;
+
+		FString GetPath() const;
+
+	private:
+		FString Name;
+		FString Columns;
+		FString RunTag;
+		TArray<FString> Rows;
+	};
+
+	// Game world without a viewport, for spawning and ticking systems under -nullrhi
+	class FHeadlessWorld
+	{
+	public:
+		FHeadlessWorld();
+		~FHeadlessWorld();
+
+		UWorld* Get() const { return World; }
+
+		void Tick(int32 NumFrames = 1, float DeltaSeconds = 1.0f / 60.0f);
+
+	private:
+		UWorld* World = nullptr;
+	};
+}
@@ -0,0 +1,182 @@
+// Property of Lucian Tranc
+
+#include "NTTTestHelpers.h"
+#include "NTTDataInterface.h"
+#include "NTTTextLayout.h"
+#include "NTTVMKernels.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NTTVMKernelBenchmarkPrivate
+{
+	// Per-instance loops GetCharacterUV and GetCharacterPosition ran before NTTVMKernels, ported onto plain arrays.
+	// The Verbose logs they wrote for the first four instances are left out.
+	void LegacyGetCharacterUV(const FNTTTextLayout& Layout, const FNTTGlyphTable& GlyphTable, NTTVMKernels::FArrayIndexInput InCharacterIndex, int32 NumInstances, float* const (&Dest)[4])
+	{
+		const TArray<int32>& GlyphIndices = Layout.GlyphIndices;
+		const TArray<FVector4f>& TextureUvs = GlyphTable.GlyphTextureUvs;
+		const int32 NumRects = TextureUvs.Num();
+		const int32 NumChars = GlyphIndices.Num();
+
+		for (int32 i = 0; i < NumInstances; ++i)
+		{
+			int32 CharacterIndex = InCharacterIndex.GetAndAdvance();
+			if (NumChars > 0)
+			{
+				CharacterIndex = CharacterIndex % NumChars;
+			}
+
+			const int32 GlyphIndex = GlyphIndices.IsValidIndex(CharacterIndex) ? GlyphIndices[CharacterIndex] : -1;
+			if (NumRects > 0 && GlyphIndex >= 0 && GlyphIndex < NumRects)
+			{
+				const FVector4f& UVRect = TextureUvs[GlyphIndex];
+				Dest[0][i] = UVRect.X;
+				Dest[1][i] = UVRect.Y;
+				Dest[2][i] = UVRect.Z;
+				Dest[3][i] = UVRect.W;
+			}
+			else
+			{
+				Dest[0][i] = 0.0f;
+				Dest[1][i] = 0.0f;
+				Dest[2][i] = 0.0f;
+				Dest[3][i] = 0.0f;
+			}
+		}
+	}
+
+	void LegacyGetCharacterPosition(const FNTTTextLayout& Layout, NTTVMKernels::FArrayIndexInput InCharacterIndex, int32 NumInstances, float* const (&Dest)[3])
+	{
+		const TArray<FVector2f>& Positions = Layout.CharacterPositions;
+		const int32 NumChars = Layout.NumCharacters();
+
+		for (int32 i = 0; i < NumInstances; ++i)
+		{
+			int32 Index = InCharacterIndex.GetAndAdvance();
+			FVector3f Position(0.0f, 0.0f, 0.0f);
+			if (NumChars > 0)
+			{
+				Index = Index % NumChars;
+				const FVector2f Position2 = Positions.IsValidIndex(Index) ? Positions[Index] : FVector2f(0.0f, 0.0f);
+				Position = FVector3f(0.0f, -Position2.X, -Position2.Y);
+			}
+			Dest[0][i] = Position.X;
+			Dest[1][i] = Position.Y;
+			Dest[2][i] = Position.Z;
+		}
+	}
+
+	template<int32 NumChannels>
+	bool AreOutputsEqual(const TArray<float> (&A)[NumChannels], const TArray<float> (&B)[NumChannels])
+	{
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			if (A[Channel] != B[Channel])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+// Instances per second of the VM functions every CPU text emitter calls per particle, before and after NTTVMKernels.
+// One particle per character, with the character index varying per particle or uniform across the batch. The Niagara VM's
+// own overhead isn't included; NiagaraTextToolkit.Benchmark.SystemTick covers the whole system.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNTTVMKernelBenchmark, "NiagaraTextToolkit.Benchmark.VMKernels", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNTTVMKernelBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace NTTVMKernelBenchmarkPrivate;
+
+	const FNTTGlyphTableRef GlyphTable = NTTTests::LoadTestGlyphTable();
+	if (!GlyphTable.IsValid())
+	{
+		AddError(TEXT("Could not build the glyph table of the test font"));
+		return false;
+	}
+
+	NTTTests::FBenchmarkCsv Csv(TEXT("VMKernels"), TEXT("Function,Index,Instances,Mode,Iterations,MInstancesPerSecond"));
+	const FNTTLayoutParams Params;
+	const FNTTGlyphChannels& Channels = GlyphTable->Channels;
+	const float* const UVSrc[4] = { Channels.USize.GetData(), Channels.VSize.GetData(), Channels.UStart.GetData(), Channels.VStart.GetData() };
+
+	for (const int32 NumInstances : { 64, 1024, 65536 })
+	{
+		FNTTTextLayout Layout;
+		FNTTTextLayoutEngine::Build(*GlyphTable, Params, NTTTests::MakeText(NumInstances), Layout);
+
+		TArray<int32> CharacterIndices;
+		CharacterIndices.SetNumUninitialized(NumInstances);
+		for (int32 Index = 0; Index < NumInstances; ++Index)
+		{
+			CharacterIndices[Index] = Index;
+		}
+
+		TArray<float> LegacyOutputs[4];
+		TArray<float> KernelOutputs[4];
+		for (int32 Channel = 0; Channel < 4; ++Channel)
+		{
+			LegacyOutputs[Channel].SetNumZeroed(NumInstances);
+			KernelOutputs[Channel].SetNumZeroed(NumInstances);
+		}
+		float* const LegacyDest[4] = { LegacyOutputs[0].GetData(), LegacyOutputs[1].GetData(), LegacyOutputs[2].GetData(), LegacyOutputs[3].GetData() };
+		float* const KernelDest[4] = { KernelOutputs[0].GetData(), KernelOutputs[1].GetData(), KernelOutputs[2].GetData(), KernelOutputs[3].GetData() };
+		float* const LegacyPositionDest[3] = { LegacyDest[0], LegacyDest[1], LegacyDest[2] };
+
+		// Small batches are repeated so every timed call covers about the same number of instances
+		const int32 NumRepeats = FMath::Max(1, 65536 / NumInstances);
+
+		for (const bool bUniform : { false, true })
+		{
+			NTTVMKernels::FArrayIndexInput Input;
+			Input.Data = bUniform ? &CharacterIndices[NumInstances / 2] : CharacterIndices.GetData();
+			Input.Stride = bUniform ? 0 : 1;
+			const TCHAR* IndexName = bUniform ? TEXT("Uniform") : TEXT("PerParticle");
+
+			auto Measure = [&](const TCHAR* FunctionName, const TCHAR* ModeName, TFunctionRef<void()> Run)
+			{
+				int32 Iterations = 0;
+				const double Seconds = NTTTests::TimeIterations([&]()
+				{
+					for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+					{
+						Run();
+					}
+				}, Iterations);
+
+				const FString Row = FString::Printf(TEXT("%s,%s,%d,%s,%d,%.1f"), FunctionName, IndexName, NumInstances, ModeName, Iterations, (double)NumInstances * NumRepeats / Seconds / 1000000.0);
+				AddInfo(Row);
+				Csv.AddRow(Row);
+			};
+
+			Measure(TEXT("GetCharacterUV"), TEXT("Legacy"), [&]()
+			{
+				LegacyGetCharacterUV(Layout, *GlyphTable, Input, NumInstances, LegacyDest);
+			});
+			Measure(TEXT("GetCharacterUV"), TEXT("Kernel"), [&]()
+			{
+				NTTVMKernels::FArrayIndexInput KernelInput = Input;
+				NTTVMKernels::GatherGlyphChannels(NumInstances, Layout, *GlyphTable, KernelInput, UVSrc, KernelDest);
+			});
+			TestTrue(FString::Printf(TEXT("GetCharacterUV %s %d matches the legacy loop"), IndexName, NumInstances), AreOutputsEqual(LegacyOutputs, KernelOutputs));
+
+			Measure(TEXT("GetCharacterPosition"), TEXT("Legacy"), [&]()
+			{
+				LegacyGetCharacterPosition(Layout, Input, NumInstances, LegacyPositionDest);
+			});
+			Measure(TEXT("GetCharacterPosition"), TEXT("Kernel"), [&]()
+			{
+				NTTVMKernels::FArrayIndexInput KernelInput = Input;
+				NTTVMKernels::GatherCharacterPositions(NumInstances, Layout, KernelInput, KernelDest[0], KernelDest[1], KernelDest[2]);
+			});
+			TestTrue(FString::Printf(TEXT("GetCharacterPosition %s %d matches the legacy loop"), IndexName, NumInstances), AreOutputsEqual(LegacyOutputs, KernelOutputs));
+		}
+	}
+
+	TestTrue(TEXT("Results written to ") + Csv.GetPath(), Csv.Write());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
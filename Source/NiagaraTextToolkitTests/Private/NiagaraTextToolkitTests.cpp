@@ -0,0 +1,7 @@
+// Property of Lucian Tranc
+
+#include "Modules/ModuleManager.h"
+
+// Automation tests and benchmarks for NiagaraTextToolkit. Run them headless with
+// UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests NiagaraTextToolkit; Quit"
+IMPLEMENT_MODULE(FDefaultModuleImpl, NiagaraTextToolkitTests)